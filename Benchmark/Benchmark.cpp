@@ -0,0 +1,253 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Measures the cost of the ConsoleTools string builders and output paths.
+ *
+ * Every benchmark renders into memory (nothing is printed while timing), so the numbers
+ * reflect the library itself rather than the terminal.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ConsoleTools.h"
+
+namespace {
+
+    // Accumulates output sizes so the compiler cannot drop the work being measured.
+    volatile std::size_t sink = 0;
+
+    /**
+     * @brief Runs Body Iterations times and prints the average time per call.
+     */
+    template <typename Function>
+    void Run(const char* Name, int Iterations, Function Body) {
+        // Warm up caches and thread-local buffers first.
+        for (int i = 0; i < Iterations / 10; i++) {
+            Body(i);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Iterations; i++) {
+            Body(i);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / Iterations;
+        std::printf("%-32s %10.1f ns/op\n", Name, nanoseconds);
+    }
+
+} // namespace
+
+int main() {
+    using namespace ConsoleTools;
+    const int iterations = 200000;
+
+    Run("Header", iterations, [](int) {
+        sink = sink + Header("=", 10, "HEADER", " ", Color::CYAN, Color::YELLOW, Color::GREEN).size();
+    });
+
+    Run("AdvancedHeader", iterations, [](int) {
+        sink = sink + AdvancedHeader("=", 8, "-", 8, "ADVANCED HEADER", " ", Color::LIGHT_BLUE,
+            Color::LIGHT_PURPLE, Color::GREEN, Color::YELLOW, true).size();
+    });
+
+    Run("ProgressBar", iterations, [](int i) {
+        sink = sink + ProgressBar(i % 101, 100, 40, Color::GREEN, true, Color::LIGHT_CYAN).size();
+    });
+
+    Run("AdvancedProgressBar", iterations, [](int i) {
+        sink = sink + AdvancedProgressBar(i % 101, 100, 40, "Loading", "Complete", "#", "-", Color::GREEN,
+            Color::GRAY, Color::WHITE, Color::YELLOW, Color::LIGHT_BLUE, Color::RED, true, true, true).size();
+    });
+
+    Run("CachedAdvancedProgressBar", iterations, [](int i) {
+        sink = sink + CachedAdvancedProgressBar(i % 101, 100, 40, "Loading", "Complete", "#", "-", Color::GREEN,
+            Color::GRAY, Color::WHITE, Color::YELLOW, Color::LIGHT_BLUE, Color::RED, true, true, true).size();
+    });
+
+    {
+        FrameArena arena;
+        Run("AdvancedProgressBar (FrameArena)", iterations, [&arena](int i) {
+            sink = sink + AdvancedProgressBar(arena.Resource(), i % 101, 100, 40, "Loading", "Complete", "#", "-",
+                Color::GREEN, Color::GRAY, Color::WHITE, Color::YELLOW, Color::LIGHT_BLUE, Color::RED,
+                true, true, true).size();
+            arena.Reset();
+        });
+    }
+
+    Run("AdvancedProgressBarView", iterations, [](int i) {
+        sink = sink + AdvancedProgressBarView(i % 101, 100, 40, "Loading", "Complete", "#", "-", Color::GREEN,
+            Color::GRAY, Color::WHITE, Color::YELLOW, Color::LIGHT_BLUE, Color::RED, true, true, true).size();
+    });
+
+    Run("Error", iterations, [](int) {
+        sink = sink + Error("Something went wrong").size();
+    });
+
+    Run("Notification", iterations, [](int) {
+        sink = sink + Notification("[", "!", "]", "INFO", "This is a notification message!",
+            Color::LIGHT_CYAN, Color::GREEN, Color::WHITE).size();
+    });
+
+    Run("NotificationView", iterations, [](int) {
+        sink = sink + NotificationView("[", "!", "]", "INFO", "This is a notification message!",
+            Color::LIGHT_CYAN, Color::GREEN, Color::WHITE).size();
+    });
+
+    {
+        SeriesBuffer series(600);
+        Run("SeriesBuffer::Push", iterations, [&series](int i) {
+            series.Push(static_cast<double>((i * 7919) % 1000));
+        });
+        Run("SparklineView (600 -> 60)", iterations / 10, [&series](int) {
+            sink = sink + SparklineView(series, 60).size();
+        });
+    }
+
+    {
+        ConcurrentHistogram latencies;
+        Run("ConcurrentHistogram::Record", iterations, [&latencies](int i) {
+            latencies.Record(static_cast<std::uint64_t>(i) * 2654435761u % 10000000u);
+        });
+        LogLinearHistogram snapshot = latencies.Snapshot();
+        Run("HistogramBarsView (16 rows)", iterations / 10, [&snapshot](int) {
+            sink = sink + HistogramBarsView(snapshot, 16, 40).size();
+        });
+    }
+
+    {
+        Layout layout(LayoutDirection::Column);
+        int top = layout.Add(Layout::ROOT, LayoutSize::Fixed(3));
+        int body = layout.Add(Layout::ROOT, LayoutSize::Flex(), LayoutDirection::Row);
+        layout.Add(body, LayoutSize::Percent(30));
+        layout.Add(body, LayoutSize::Flex());
+        layout.SetBorder(top, Borders::ROUNDED, "Build", Color::CYAN);
+        layout.Resize(120, 40);
+        FrameBuffer frame(120, 40);
+        layout.DrawBorders(frame);
+        frame.Render();
+        Run("FrameBuffer Write + Render", iterations / 10, [&](int i) {
+            layout.Draw(frame, top, ProgressBarView(i % 101, 100, 100, Color::GREEN, true, Color::LIGHT_CYAN));
+            sink = sink + frame.Render().size();
+        });
+    }
+
+    {
+        std::string alert;
+        for (int i = 0; i < 200; i++) {
+            alert += (i % 10 == 0) ? "\033[33mwarning\033[0m " : "replica lagging behind primary ";
+        }
+        Run("WrapTextView (5 KB, greedy)", iterations / 100, [&alert](int) {
+            sink = sink + WrapTextView(alert, 80, 4).size();
+        });
+        Run("WrapTextView (5 KB, balanced)", iterations / 100, [&alert](int) {
+            sink = sink + WrapTextView(alert, 80, 4, WrapMode::Balanced).size();
+        });
+    }
+
+    Run("RenderMarkupView (cached)", iterations, [](int) {
+        sink = sink + RenderMarkupView("[bold red]{}[/] failed after [yellow]{}[/] retries", { "deploy", "3" }).size();
+    });
+
+    Run("CONSOLETOOLS_MARKUP RenderView", iterations, [](int) {
+        static constexpr auto alert = CONSOLETOOLS_MARKUP("[bold red]{}[/] failed after [yellow]{}[/] retries");
+        sink = sink + alert.RenderView({ "deploy", "3" }).size();
+    });
+
+    {
+        std::string line;
+        Run("FormatTo (status line)", iterations, [&line](int i) {
+            line.clear();
+            FormatTo(line, "[bold]{}[/] {:>3}% {:>8.2f green} MB/s eta {}s", "upload", i % 101, i * 0.37, i % 60);
+            sink = sink + line.size();
+        });
+    }
+
+    {
+        ProgressBarStyle style;
+        style.FillColor = Color::GREEN;
+        style.UnfilledColor = Color::GRAY;
+        style.TextColor = Color::WHITE;
+        std::vector<int> current(1000), maximum(1000, 100);
+        std::vector<std::string_view> labels(1000, "worker ");
+        for (int i = 0; i < 1000; i++) {
+            current[i] = (i * 37) % 101;
+        }
+        Run("AdvancedProgressBarView x1000", iterations / 1000, [&](int) {
+            for (int i = 0; i < 1000; i++) {
+                sink = sink + AdvancedProgressBarView(current[i], maximum[i], style.BarWidth, labels[i], "", "#", "-",
+                    style.FillColor, style.UnfilledColor, style.TextColor, "", "", "", true, true, true).size();
+            }
+        });
+        Run("AdvancedProgressBarsView (1000)", iterations / 1000, [&](int) {
+            sink = sink + AdvancedProgressBarsView(style, current.data(), maximum.data(), labels.data(), 1000).size();
+        });
+    }
+
+    {
+        ProgressBarStyle style;
+        style.SuffixText = "Complete";
+        style.FillColor = Color::GREEN;
+        style.UnfilledColor = Color::GRAY;
+        style.TextColor = Color::WHITE;
+        style.PrefixColor = Color::YELLOW;
+        style.SuffixColor = Color::LIGHT_BLUE;
+        style.BracketColor = Color::RED;
+        ProgressBarWidget bar(style, "Loading");
+        std::string line;
+        Run("ProgressBarWidget::RenderTo", iterations, [&bar, &line](int i) {
+            line.clear();
+            sink = sink + bar.RenderTo(line, i % 101, 100).size();
+        });
+
+        NotificationStyle notificationStyle;
+        notificationStyle.BorderCharacterColor = Color::LIGHT_CYAN;
+        notificationStyle.InsideCharacterColor = Color::GREEN;
+        notificationStyle.NotificationTextColor = Color::WHITE;
+        const NotificationWidget notification(notificationStyle);
+        Run("NotificationWidget::RenderTo", iterations, [&notification, &line](int) {
+            line.clear();
+            sink = sink + notification.RenderTo(line, "This is a notification message!").size();
+        });
+    }
+
+    Run("VisibleWidth", iterations, [](int) {
+        sink = sink + static_cast<std::size_t>(VisibleWidth("\033[36m=====\033[0m HEADER \033[36m=====\033[0m"));
+    });
+
+    {
+        CaptureSink capture;
+        SetOutputSink(&capture);
+        for (int i = 0; i <= 100; i++) {
+            Print("\r");
+            Print(ProgressBar(i, 100, 40, Color::GREEN, true, Color::LIGHT_CYAN));
+            FlushOutput();
+        }
+        SetOutputSink(nullptr);
+
+        std::string bytes = capture.Bytes();
+        Run("VirtualTerminal replay (101 frames)", 2000, [&bytes](int) {
+            VirtualTerminal screen(80, 24);
+            screen.Feed(bytes);
+            sink = sink + static_cast<std::size_t>(screen.CursorColumn());
+        });
+        std::printf("%-32s %10.1f bytes/frame\n", "ProgressBar frame size", capture.BytesPerFrame());
+    }
+
+    {
+        // Animations run against a virtual clock, so this measures rendering rather than sleeping.
+        VirtualClock clock;
+        CaptureSink capture;
+        SetClock(&clock);
+        SetOutputSink(&capture);
+        Run("PrintSpinner 1s @ 50ms (virtual)", 2000, [&capture](int) {
+            PrintSpinner(1000, 50);
+            capture.Clear();
+        });
+        SetOutputSink(nullptr);
+        SetClock(nullptr);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file Training.cpp
+ * @brief Non-interactive workload used to collect PGO/AutoFDO profiles for ConsoleTools.
+ *
+ * Replays the kind of work a dashboard or CLI tool does all day (redrawing many progress bars,
+ * bursts of headers, notifications and log lines, answering numbered menus) with all output
+ * going to a CaptureSink, so it needs no terminal and no user input.
+ *
+ * Usage: ConsoleToolsTraining [rounds]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ConsoleTools.h"
+
+namespace {
+
+    using namespace ConsoleTools;
+
+    /**
+     * @brief Redraws a block of progress bars in place, the way a multi-task dashboard does.
+     */
+    void MultiBarUpdates(int Bars, int Steps) {
+        const char* fillColors[] = { Color::GREEN, Color::LIGHT_GREEN, Color::CYAN, Color::YELLOW };
+
+        for (int step = 0; step <= Steps; step++) {
+            std::string frame;
+            if (step > 0) {
+                frame.append("\033[" + std::to_string(Bars) + "A");
+            }
+            for (int bar = 0; bar < Bars; bar++) {
+                // Bars advance at different speeds, and some stall, like real tasks.
+                int progress = (bar % 5 == 0) ? std::min(step, Steps / 3) : (step * (bar % 7 + 1)) % (Steps + 1);
+                frame.append("\r");
+                if (bar % 3 == 0) {
+                    frame.append(ProgressBar(progress, Steps, 30, fillColors[bar % 4], true, Color::LIGHT_CYAN));
+                }
+                else if (bar % 3 == 1) {
+                    frame.append(AdvancedProgressBar(progress, Steps, 40, "task-" + std::to_string(bar), "running",
+                        "#", "-", fillColors[bar % 4], Color::GRAY, Color::WHITE, Color::YELLOW, Color::LIGHT_BLUE,
+                        Color::RED, true, true, true));
+                }
+                else {
+                    frame.append(CachedAdvancedProgressBar(progress, Steps, 40, "job", "", "=", " ",
+                        fillColors[bar % 4], Color::GRAY, Color::WHITE, Color::YELLOW, Color::LIGHT_BLUE,
+                        Color::GRAY, true, true, true));
+                }
+                frame.append("\n");
+            }
+            Print(frame);
+            FlushOutput();
+        }
+    }
+
+    /**
+     * @brief Emits bursts of headers, notifications, errors, warnings and log lines.
+     */
+    void MessageBursts(int Messages, std::ostream& LogStream) {
+        DefaultLogger().SetOutput(LogStream);
+
+        for (int i = 0; i < Messages; i++) {
+            std::string index = std::to_string(i);
+            std::string burst;
+            burst.append(Header("=", 10 + i % 5, "SECTION " + index, " ", Color::CYAN, Color::YELLOW, Color::GREEN));
+            burst.append("\n");
+            burst.append(AdvancedHeader("=", 4, "-", 12, "Status", " ", Color::LIGHT_BLUE, Color::LIGHT_PURPLE,
+                Color::GREEN, Color::YELLOW, true));
+            burst.append("\n");
+            burst.append(Notification("[", "!", "]", "INFO", "Request " + index + " completed",
+                Color::LIGHT_CYAN, Color::GREEN, Color::WHITE));
+            burst.append("\n");
+            burst.append(Error("Connection reset by peer (attempt " + index + ")"));
+            burst.append(Color::RESET);
+            burst.append("\n");
+            burst.append(Warning("Retrying in " + std::to_string(i % 10) + "s"));
+            burst.append(Color::RESET);
+            burst.append("\n");
+            burst.append(RateLimitedWarning("Disk usage above 90%"));
+            burst.append(Spacing(1));
+            Print(burst);
+            FlushOutput();
+
+            CONSOLETOOLS_LOG_INFO("processed batch ", i, " in ", 12.5, "ms");
+            CONSOLETOOLS_LOG_WARNING("slow response from shard ", i % 8);
+            CONSOLETOOLS_LOG_DEBUG("cache hit ratio ", 0.93);
+        }
+
+        DefaultLogger().SetOutput(std::cerr);
+    }
+
+    /**
+     * @brief Answers numbered menus with a mix of valid and invalid input.
+     */
+    void MenuSelections(int Rounds) {
+        std::vector<std::string> options;
+        for (int i = 0; i < 12; i++) {
+            options.push_back("Service " + std::to_string(i));
+        }
+
+        const char* answers[] = { "3", "12", "abc", "0", "99999999999999", "7" };
+        std::string input;
+        for (int i = 0; i < Rounds; i++) {
+            input.append(answers[i % 6]);
+            input.append("\n");
+        }
+
+        std::istringstream scriptedInput(input);
+        std::streambuf* previous = std::cin.rdbuf(scriptedInput.rdbuf());
+        for (int i = 0; i < Rounds; i++) {
+            PromptNumberedMenu(options, ": ", "Select a service:", "Choice: ", Color::WHITE, Color::LIGHT_BLUE,
+                Color::GREEN, Color::YELLOW, Color::LIGHT_PURPLE, Color::LIGHT_RED);
+        }
+        std::cin.rdbuf(previous);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int rounds = (argc > 1) ? std::atoi(argv[1]) : 20;
+    if (rounds <= 0) {
+        rounds = 20;
+    }
+
+    CaptureSink capture;
+    std::ostringstream logStream;
+    ConsoleTools::SetOutputSink(&capture);
+
+    std::size_t bytes = 0;
+    for (int round = 0; round < rounds; round++) {
+        MultiBarUpdates(64, 100);
+        MessageBursts(200, logStream);
+        MenuSelections(50);
+
+        // Keep memory flat across long training runs.
+        bytes += capture.Bytes().size() + logStream.str().size();
+        capture.Clear();
+        logStream.str(std::string());
+    }
+
+    ConsoleTools::SetOutputSink(nullptr);
+    std::cout << "Trained " << rounds << " rounds, rendered " << bytes << " bytes.\n";
+    return 0;
+}
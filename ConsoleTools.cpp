@@ -1,558 +1,6686 @@
-/**
- * @file ConsoleTools.cpp
- * @brief Implementation of the ConsoleTools library for various console functions such as
- * coloring text, creating headers, progress bars, notifications, etc.
- */
-
-#include <iostream>
-#include <string>
-#include <thread>
-#include <chrono>
-#include <random>
-#include <stdexcept>
-#include <vector>
-#include <limits>
-
-namespace ConsoleTools {
-
-    /**
-     * @struct Color
-     * @brief Stores static inline console color escape codes for easy access.
-     */
-    struct Color {
-        // -- Standard colors --
-        static inline constexpr const char* RED = "\033[31m";
-        static inline constexpr const char* ORANGE = "\033[38;5;208m";
-        static inline constexpr const char* YELLOW = "\033[33m";
-        static inline constexpr const char* GREEN = "\033[32m";
-        static inline constexpr const char* BLUE = "\033[34m";
-        static inline constexpr const char* PURPLE = "\033[35m";
-        static inline constexpr const char* CYAN = "\033[36m";
-
-        // -- Normal colors --
-        static inline constexpr const char* WHITE = "\033[37m";
-        static inline constexpr const char* GRAY = "\033[90m";
-        static inline constexpr const char* BLACK = "\033[30m";
-
-        // -- Light colors --
-        static inline constexpr const char* LIGHT_RED = "\033[91m";
-        static inline constexpr const char* LIGHT_ORANGE = "\033[38;5;214m";
-        static inline constexpr const char* LIGHT_YELLOW = "\033[93m";
-        static inline constexpr const char* LIGHT_GREEN = "\033[92m";
-        static inline constexpr const char* LIGHT_BLUE = "\033[94m";
-        static inline constexpr const char* LIGHT_PURPLE = "\033[95m";
-        static inline constexpr const char* LIGHT_CYAN = "\033[96m";
-
-        // -- Reset --
-        static inline constexpr const char* RESET = "\033[0m";
-
-        // -- Custom Colors --
-        // if you want to create your own custom color,
-        // follow the format of [static inline constexpr const char* COLORNAME = "ANSI_CODE"]
-    };
-
-    /**
-     * @brief Pauses the console until the user presses Enter.
-     * @param message A message printed before waiting for user input.
-     * @return void
-     */
-    void PauseConsole(const std::string& message) {
-        std::cout << message << std::endl;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    }
-
-    /**
-     * @brief Creates a string consisting of line-break characters.
-     * @param NumberOfSpaces The number of newlines to append.
-     * @return A string containing the specified number of newline characters.
-     */
-    std::string Spacing(int NumberOfSpaces) {
-        std::string spacing;
-        for (int i = 0; i < NumberOfSpaces; i++) {
-            spacing.append("\n");
-        }
-        return spacing;
-    }
-
-    /**
-     * @brief Creates a header string with repeated line characters, spacing characters, and colored text.
-     * @param LineCharacter The character used to create the repeated line segments.
-     * @param LineCharacterCount The number of times to repeat the line character on each side.
-     * @param HeaderText The text that appears in the center of the header.
-     * @param SpacingCharacter The character to insert between the line segments and the header text.
-     * @param LineColor The color code for the repeated line segments.
-     * @param HeaderTextColor The color code for the header text.
-     * @param SpacingCharacterColor The color code for the spacing character.
-     * @return The fully constructed header string.
-     */
-    std::string Header(const std::string& LineCharacter,
-        int LineCharacterCount,
-        const std::string& HeaderText,
-        const std::string& SpacingCharacter,
-        const std::string& LineColor,
-        const std::string& HeaderTextColor,
-        const std::string& SpacingCharacterColor)
-    {
-        std::string header;
-        std::string lineSegment;
-
-        // Create the repeated line segment
-        for (int i = 0; i < LineCharacterCount; i++) {
-            lineSegment.append(LineCharacter);
-        }
-
-        // Build the header
-        header.append(LineColor);
-        header.append(lineSegment);
-
-        header.append(SpacingCharacterColor);
-        header.append(SpacingCharacter);
-
-        header.append(HeaderTextColor);
-        header.append(HeaderText);
-
-        header.append(SpacingCharacterColor);
-        header.append(SpacingCharacter);
-
-        header.append(LineColor);
-        header.append(lineSegment);
-
-        header.append(Color::RESET);
-
-        return header;
-    }
-
-    /**
-     * @brief Creates a header with two different line characters on the left and right, colored differently if desired.
-     * @param LeftLineCharacter Character repeated on the left side of the header.
-     * @param LeftLineCharacterCount Number of times to repeat the left line character.
-     * @param RightLineCharacter Character repeated on the right side of the header.
-     * @param RightLineCharacterCount Number of times to repeat the right line character.
-     * @param HeaderText The text that appears in the center of the header.
-     * @param SpacingCharacter The character to insert between the line segments and the header text.
-     * @param LeftLineColor Color code for the left line segment.
-     * @param RightLineColor Color code for the right line segment.
-     * @param HeaderTextColor Color code for the header text.
-     * @param SpacingCharacterColor Color code for the spacing character.
-     * @param ResetColorOnEnd Whether to reset color codes at the end of the header.
-     * @return The fully constructed advanced header string.
-     */
-    std::string AdvancedHeader(const std::string& LeftLineCharacter,
-        int LeftLineCharacterCount,
-        const std::string& RightLineCharacter,
-        int RightLineCharacterCount,
-        const std::string& HeaderText,
-        const std::string& SpacingCharacter,
-        const std::string& LeftLineColor,
-        const std::string& RightLineColor,
-        const std::string& HeaderTextColor,
-        const std::string& SpacingCharacterColor,
-        bool ResetColorOnEnd)
-    {
-        std::string header;
-        std::string LlineSegment;
-        std::string RlineSegment;
-
-        // Create the repeated line segments
-        for (int i = 0; i < LeftLineCharacterCount; i++) {
-            LlineSegment.append(LeftLineCharacter);
-        }
-        for (int i = 0; i < RightLineCharacterCount; i++) {
-            RlineSegment.append(RightLineCharacter);
-        }
-
-        // Build the header
-        header.append(LeftLineColor);
-        header.append(LlineSegment);
-
-        header.append(SpacingCharacterColor);
-        header.append(SpacingCharacter);
-
-        header.append(HeaderTextColor);
-        header.append(HeaderText);
-
-        header.append(SpacingCharacterColor);
-        header.append(SpacingCharacter);
-
-        header.append(RightLineColor);
-        header.append(RlineSegment);
-
-        if (ResetColorOnEnd) {
-            header.append(Color::RESET);
-        }
-
-        return header;
-    }
-
-    /**
-     * @brief Creates a simple progress bar with a filled and unfilled portion, optionally showing a percentage.
-     * @param CurrentProgress The current progress value (must be <= MaxProgress).
-     * @param MaxProgress The maximum progress value.
-     * @param BarWidth The total width of the progress bar in characters.
-     * @param BarColor The color code for the filled portion of the bar.
-     * @param ShowPercentage Whether to display the numeric percentage.
-     * @param PercentageColor The color code for the percentage display.
-     * @return The constructed progress bar string.
-     */
-    std::string ProgressBar(int CurrentProgress,
-        int MaxProgress,
-        int BarWidth,
-        const std::string& BarColor,
-        bool ShowPercentage,
-        const std::string& PercentageColor)
-    {
-        // Clamp progress values to bounds
-        if (CurrentProgress > MaxProgress) {
-            CurrentProgress = MaxProgress;
-        }
-        if (CurrentProgress < 0) {
-            CurrentProgress = 0;
-        }
-
-        // Calculate progress fraction
-        double progress = static_cast<double>(CurrentProgress) / MaxProgress;
-        int filledWidth = static_cast<int>(progress * BarWidth);
-        int remainingWidth = BarWidth - filledWidth;
-
-        // Build the bar
-        std::string bar;
-        bar.append(BarColor);
-
-        // Filled portion
-        for (int i = 0; i < filledWidth; i++) {
-            bar.push_back('#');
-        }
-        // Unfilled portion
-        for (int i = 0; i < remainingWidth; i++) {
-            bar.push_back('-');
-        }
-
-        bar.append(Color::RESET);
-
-        // Optionally show percentage
-        if (ShowPercentage) {
-            int percentage = static_cast<int>(progress * 100);
-            bar.push_back(' ');
-            bar.append(PercentageColor);
-            bar.append(std::to_string(percentage));
-            bar.push_back('%');
-            bar.append(Color::RESET);
-        }
-
-        return bar;
-    }
-
-    /**
-     * @brief Creates an advanced progress bar with optional brackets, prefix/suffix text, custom fill/unfill characters, and colors.
-     * @param CurrentPercentage The current progress value.
-     * @param MaxPercentage The maximum progress value.
-     * @param BarWidth The total width of the progress bar in characters.
-     * @param PrefixText A text that appears before the bar.
-     * @param SuffixText A text that appears after the bar.
-     * @param FillChar The character used to denote the filled portion of the bar.
-     * @param UnfilledChar The character used to denote the unfilled portion of the bar.
-     * @param FillColor The color code for the filled portion.
-     * @param UnfilledColor The color code for the unfilled portion.
-     * @param TextColor The color code for the percentage text.
-     * @param PrefixColor The color code for the prefix text.
-     * @param SuffixColor The color code for the suffix text.
-     * @param BracketColor The color code for the brackets.
-     * @param ShowPercentage Whether to display the numeric percentage next to the bar.
-     * @param ShowBrackets Whether to display brackets around the bar.
-     * @param ResetColorOnCompletion Whether to reset color codes after building the bar.
-     * @return The constructed advanced progress bar string.
-     */
-    std::string AdvancedProgressBar(int CurrentPercentage,
-        int MaxPercentage,
-        int BarWidth,
-        const std::string& PrefixText,
-        const std::string& SuffixText,
-        const std::string& FillChar,
-        const std::string& UnfilledChar,
-        const std::string& FillColor,
-        const std::string& UnfilledColor,
-        const std::string& TextColor,
-        const std::string& PrefixColor,
-        const std::string& SuffixColor,
-        const std::string& BracketColor,
-        bool ShowPercentage,
-        bool ShowBrackets,
-        bool ResetColorOnCompletion)
-    {
-        // Clamp current progress
-        if (CurrentPercentage < 0) {
-            CurrentPercentage = 0;
-        }
-        if (CurrentPercentage > MaxPercentage) {
-            CurrentPercentage = MaxPercentage;
-        }
-
-        // Calculate progress fraction, avoid divide-by-zero
-        double progress = (MaxPercentage != 0)
-            ? static_cast<double>(CurrentPercentage) / MaxPercentage
-            : 0.0;
-        int filledWidth = static_cast<int>(progress * BarWidth);
-        int remainingWidth = BarWidth - filledWidth;
-
-        std::string result;
-
-        // Prefix
-        if (!PrefixText.empty()) {
-            result.append(PrefixColor);
-            result.append(PrefixText);
-        }
-
-        // Optional brackets
-        if (ShowBrackets) {
-            result.append(BracketColor);
-            result.push_back('[');
-        }
-
-        // Filled portion
-        result.append(FillColor);
-        for (int i = 0; i < filledWidth; i++) {
-            result.append(FillChar);
-        }
-
-        // Unfilled portion
-        result.append(UnfilledColor);
-        for (int i = 0; i < remainingWidth; i++) {
-            result.append(UnfilledChar);
-        }
-
-        // Close brackets
-        if (ShowBrackets) {
-            result.append(BracketColor);
-            result.push_back(']');
-        }
-
-        // Show percentage
-        if (ShowPercentage) {
-            int percentageValue = static_cast<int>(progress * 100);
-            result.append(TextColor);
-            result.append(" ");
-            result.append(std::to_string(percentageValue));
-            result.push_back('%');
-        }
-
-        // Suffix
-        if (!SuffixText.empty()) {
-            result.append(" ");
-            result.append(SuffixColor);
-            result.append(SuffixText);
-        }
-
-        if (ResetColorOnCompletion) {
-            result.append(Color::RESET);
-        }
-
-        return result;
-    }
-
-    /**
-     * @brief Creates an error message string in red color.
-     * @param Message The error message to display.
-     * @return A colored error string prefixed with "[ERROR]: ".
-     */
-    std::string Error(const std::string& Message) {
-        std::string error;
-        error.append(Color::LIGHT_RED);
-        error.append("[ERROR]: ");
-        error.append(Message);
-        return error;
-    }
-
-    /**
-     * @brief Creates a warning message string in yellow color.
-     * @param Message The warning message to display.
-     * @return A colored warning string prefixed with "[WARNING]: ".
-     */
-    std::string Warning(const std::string& Message) {
-        std::string warning;
-        warning.append(Color::LIGHT_YELLOW);
-        warning.append("[WARNING]: ");
-        warning.append(Message);
-        return warning;
-    }
-
-    /**
-     * @brief Prints text to the console with a random delay between each character to simulate a typing effect.
-     * @param Text The text to print.
-     * @param MinDelayMilliseconds The minimum delay between characters in milliseconds.
-     * @param MaxDelayMilliseconds The maximum delay between characters in milliseconds.
-     * @return void
-     */
-    void PrintTypingTextEffect(const std::string& Text,
-        int MinDelayMilliseconds,
-        int MaxDelayMilliseconds)
-    {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> dist(MinDelayMilliseconds, MaxDelayMilliseconds);
-
-        for (char c : Text) {
-            int delay = dist(gen);
-            std::cout << c << std::flush;
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-        }
-    }
-
-    /**
-     * @brief Creates a formatted notification string with a left border, an inside character, and a right border, along with some text.
-     * @param LeftBorderCharacter The character or string used as the left border.
-     * @param InsideCharacter The character or string used inside the border (often small).
-     * @param RightBorderCharacter The character or string used as the right border.
-     * @param NotificationTypeText A label or title for the notification (e.g., "INFO", "WARNING").
-     * @param NotificationText The main notification text to display.
-     * @param BorderCharacterColor Color code for the border characters.
-     * @param InsideCharacterColor Color code for the inside character.
-     * @param NotificationTextColor Color code for the notification text.
-     * @return A formatted notification string with optional coloring.
-     */
-    std::string Notification(const std::string& LeftBorderCharacter,
-        const std::string& InsideCharacter,
-        const std::string& RightBorderCharacter,
-        const std::string& NotificationTypeText,
-        const std::string& NotificationText,
-        const std::string& BorderCharacterColor,
-        const std::string& InsideCharacterColor,
-        const std::string NotificationTextColor)
-    {
-        std::string notification;
-        notification.append(BorderCharacterColor);
-        notification.append(LeftBorderCharacter);
-
-        notification.append(InsideCharacterColor);
-        notification.append(InsideCharacter);
-
-        notification.append(BorderCharacterColor);
-        notification.append(RightBorderCharacter);
-
-        notification.append(InsideCharacterColor);
-        notification.append(" " + NotificationTypeText);
-        notification.append(": ");
-
-        notification.append(NotificationTextColor);
-        notification.append(NotificationText);
-
-        notification.append(Color::RESET);
-
-        return notification;
-    }
-
-    /**
-     * @brief Prints a spinning animation in place for a specified duration, with a chosen spin speed.
-     * @param SpinDurationMs The total duration of the spinner in milliseconds.
-     * @param SpinSpeedMs The delay between spinner frames in milliseconds.
-     * @return void
-     */
-    void PrintSpinner(int SpinDurationMs, int SpinSpeedMs) {
-        const char* spinChars = "|/-\\";
-        int spinIndex = 0;
-        auto start = std::chrono::steady_clock::now();
-
-        while (true) {
-            // Print spinning char and flush.
-            std::cout << "\r" << spinChars[spinIndex++] << std::flush;
-            if (spinIndex == 4) {
-                spinIndex = 0;
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(SpinSpeedMs));
-            auto now = std::chrono::steady_clock::now();
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() >= SpinDurationMs) {
-                break;
-            }
-        }
-
-        // Clear the spinner character.
-        std::cout << "\r " << std::endl;
-    }
-
-    /**
-     * @brief Prompts the user with a numbered menu of options and returns the users selection index (zero-based).
-     * @param Options A vector of strings representing the menu options.
-     * @param SeperatorCharacter The character (e.g. ':') separating the option index from the option text.
-     * @param PromptMessage A message displayed before listing the options.
-     * @param InputQuestionText A message asking the user to select an option.
-     * @param MessageColor Color code for the prompt message.
-     * @param NumberColor Color code for the numeric indices.
-     * @param SeperatorColor Color code for the separator character.
-     * @param OptionColor Color code for the option text.
-     * @param InputQuestionColor Color code for the question text prompting user input.
-     * @param ErrorColor Color code for any error messages (e.g., invalid input).
-     * @return The zero-based index of the users chosen option. Returns -1 if an error occurs or if no options are provided.
-     */
-    int PromptNumberedMenu(const std::vector<std::string> Options,
-        const std::string SeperatorCharacter,
-        const std::string& PromptMessage,
-        const std::string InputQuestionText,
-        const std::string MessageColor,
-        const std::string NumberColor,
-        const std::string SeperatorColor,
-        const std::string OptionColor,
-        const std::string InputQuestionColor,
-        const std::string ErrorColor)
-    {
-        if (Options.empty()) {
-            std::cerr << "No menu options provided.\n";
-            return -1;
-        }
-
-        std::cout << MessageColor << PromptMessage << "\n";
-
-        // Print each option
-        for (size_t i = 0; i < Options.size(); i++) {
-            std::cout << NumberColor << i + 1
-                << SeperatorColor << SeperatorCharacter
-                << OptionColor << Options[i]
-                << Color::RESET << std::endl;
-        }
-
-        // Ask for user input
-        std::cout << InputQuestionColor << "\n" << InputQuestionText << NumberColor;
-
-        std::string input;
-        if (!std::getline(std::cin, input)) {
-            // Input read error
-            std::cout << ErrorColor;
-            std::cerr << "Input error. Exiting.\n";
-            std::cout << Color::RESET;
-            return -1;
-        }
-
-        // Convert the user input to an integer
-        try {
-            int choice = std::stoi(input);
-            if (choice < 1 || choice > static_cast<int>(Options.size())) {
-                // Out-of-range choice
-                std::cout << ErrorColor;
-                std::cout << "Invalid choice. Please enter a number between 1 and "
-                    << Options.size() << ".\n\n";
-                std::cout << Color::RESET;
-            }
-            else {
-                // Valid choice
-                std::cout << Color::RESET;
-                return choice - 1;
-            }
-        }
-        catch (const std::invalid_argument&) {
-            // Non-integer input
-            std::cout << ErrorColor;
-            std::cout << "Invalid input. Please enter a numeric value.\n\n";
-            std::cout << Color::RESET;
-        }
-        catch (const std::out_of_range&) {
-            // Very large number that cannot fit in int
-            std::cout << ErrorColor;
-            std::cout << "The number you entered is out of range. Please try again.\n\n";
-            std::cout << Color::RESET;
-        }
-
-        // If we reach here, the input was invalid.
-        std::cout << Color::RESET;
-        return -1;
-    }
-
-} // namespace ConsoleTools
\ No newline at end of file
+/**
+ * @file ConsoleTools.cpp
+ * @brief Implementation of the ConsoleTools library for various console functions such as
+ * coloring text, creating headers, progress bars, notifications, etc.
+ */
+
+#ifndef CONSOLE_TOOLS_CPP
+#define CONSOLE_TOOLS_CPP
+
+#include "ConsoleTools.h"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <limits>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <charconv>
+#include <cctype>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <io.h>
+#include <conio.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace ConsoleTools {
+
+#if CONSOLETOOLS_ENABLE_INSTRUMENTATION
+    namespace detail {
+        /**
+         * @struct MetricCounters
+         * @brief Counters for one Metric in one thread's shard.
+         */
+        struct MetricCounters {
+            std::atomic<std::uint64_t> Calls{ 0 };
+            std::atomic<std::uint64_t> Bytes{ 0 };
+            std::atomic<std::uint64_t> Allocations{ 0 };
+            std::atomic<std::uint64_t> Latency[LogLinearHistogram::BucketCount] = {};
+            // Exact extremes, since the buckets only know a latency to within about 6%.
+            std::atomic<std::uint64_t> MinLatency{ std::numeric_limits<std::uint64_t>::max() };
+            std::atomic<std::uint64_t> MaxLatency{ 0 };
+        };
+
+        /**
+         * @struct InstrumentationShard
+         * @brief All counters of one thread. Only the owning thread writes them, so updates are plain
+         * relaxed load/store pairs without read-modify-write instructions or cache-line sharing.
+         */
+        struct InstrumentationShard {
+            MetricCounters Metrics[static_cast<int>(Metric::Count)];
+        };
+
+        /**
+         * @struct InstrumentationRegistry
+         * @brief Shards of live threads, plus the merged counters of threads that have exited.
+         */
+        struct InstrumentationRegistry {
+            std::mutex Mutex;
+            std::vector<InstrumentationShard*> Shards;
+            InstrumentationShard Retired;
+        };
+
+        inline InstrumentationRegistry& Registry() {
+            static InstrumentationRegistry registry;
+            return registry;
+        }
+
+        inline void Bump(std::atomic<std::uint64_t>& Counter, std::uint64_t Value) {
+            Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+        }
+
+        inline void Lower(std::atomic<std::uint64_t>& Counter, std::uint64_t Value) {
+            if (Value < Counter.load(std::memory_order_relaxed)) {
+                Counter.store(Value, std::memory_order_relaxed);
+            }
+        }
+
+        inline void Raise(std::atomic<std::uint64_t>& Counter, std::uint64_t Value) {
+            if (Value > Counter.load(std::memory_order_relaxed)) {
+                Counter.store(Value, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @struct ShardOwner
+         * @brief Registers a shard for the current thread and folds it into the retired totals when the thread exits.
+         */
+        struct ShardOwner {
+            InstrumentationShard* Shard;
+
+            ShardOwner()
+                : Shard(new InstrumentationShard())
+            {
+                InstrumentationRegistry& registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                registry.Shards.push_back(Shard);
+            }
+
+            ~ShardOwner() {
+                InstrumentationRegistry& registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                for (int m = 0; m < static_cast<int>(Metric::Count); m++) {
+                    MetricCounters& from = Shard->Metrics[m];
+                    MetricCounters& to = registry.Retired.Metrics[m];
+                    Bump(to.Calls, from.Calls.load(std::memory_order_relaxed));
+                    Bump(to.Bytes, from.Bytes.load(std::memory_order_relaxed));
+                    Bump(to.Allocations, from.Allocations.load(std::memory_order_relaxed));
+                    for (int b = 0; b < LogLinearHistogram::BucketCount; b++) {
+                        Bump(to.Latency[b], from.Latency[b].load(std::memory_order_relaxed));
+                    }
+                    Lower(to.MinLatency, from.MinLatency.load(std::memory_order_relaxed));
+                    Raise(to.MaxLatency, from.MaxLatency.load(std::memory_order_relaxed));
+                }
+                registry.Shards.erase(std::find(registry.Shards.begin(), registry.Shards.end(), Shard));
+                delete Shard;
+            }
+        };
+
+        inline InstrumentationShard& ThreadShard() {
+            thread_local ShardOwner owner;
+            return *owner.Shard;
+        }
+
+        /**
+         * @class ScopedMeasurement
+         * @brief Counts a call and its latency when it goes out of scope, plus whatever bytes and allocations were added.
+         */
+        class ScopedMeasurement {
+        public:
+            explicit ScopedMeasurement(Metric Id)
+                : id(Id),
+                start(std::chrono::steady_clock::now())
+            {
+            }
+
+            ~ScopedMeasurement() {
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                MetricCounters& counters = ThreadShard().Metrics[static_cast<int>(id)];
+                Bump(counters.Calls, 1);
+                Bump(counters.Bytes, bytes);
+                Bump(counters.Allocations, allocations);
+                std::uint64_t latency = static_cast<std::uint64_t>(elapsed.count());
+                Bump(counters.Latency[LogLinearHistogram::BucketIndex(latency)], 1);
+                Lower(counters.MinLatency, latency);
+                Raise(counters.MaxLatency, latency);
+            }
+
+            ScopedMeasurement(const ScopedMeasurement&) = delete;
+            ScopedMeasurement& operator=(const ScopedMeasurement&) = delete;
+
+            void AddBytes(std::size_t Count) { bytes += Count; }
+            void AddAllocation() { allocations++; }
+
+        private:
+            Metric id;
+            std::chrono::steady_clock::time_point start;
+            std::uint64_t bytes = 0;
+            std::uint64_t allocations = 0;
+        };
+
+        /**
+         * @class ScopedAppendMeasurement
+         * @brief ScopedMeasurement for a builder appending to Out: bytes are what Out grew by, and a change of
+         * capacity counts as an allocation.
+         */
+        template <typename String>
+        class ScopedAppendMeasurement : public ScopedMeasurement {
+        public:
+            ScopedAppendMeasurement(Metric Id, String& Out)
+                : ScopedMeasurement(Id),
+                out(Out),
+                size(Out.size()),
+                capacity(Out.capacity())
+            {
+            }
+
+            ~ScopedAppendMeasurement() {
+                AddBytes(out.size() - size);
+                if (out.capacity() != capacity) {
+                    AddAllocation();
+                }
+            }
+
+        private:
+            String& out;
+            std::size_t size;
+            std::size_t capacity;
+        };
+    } // namespace detail
+
+#define CONSOLETOOLS_MEASURE(Id) ::ConsoleTools::detail::ScopedMeasurement consoleToolsMeasurement(Id)
+#define CONSOLETOOLS_MEASURE_APPEND(Id, Out) \
+    ::ConsoleTools::detail::ScopedAppendMeasurement<std::remove_reference_t<decltype(Out)>> consoleToolsMeasurement(Id, Out)
+#define CONSOLETOOLS_MEASURE_BYTES(Count) consoleToolsMeasurement.AddBytes(Count)
+#else
+#define CONSOLETOOLS_MEASURE(Id) static_cast<void>(0)
+#define CONSOLETOOLS_MEASURE_APPEND(Id, Out) static_cast<void>(0)
+#define CONSOLETOOLS_MEASURE_BYTES(Count) static_cast<void>(0)
+#endif
+
+    namespace detail {
+        /**
+         * @struct LevelStyle
+         * @brief Color and prefix used when printing a message of a given LogLevel.
+         * Error() and Warning() share these entries with the Logger so both look the same.
+         */
+        struct LevelStyle {
+            std::string_view Color;
+            std::string_view Prefix;
+        };
+
+        inline constexpr LevelStyle LevelStyles[] = {
+            { Color::GRAY, "[TRACE]: " },
+            { Color::CYAN, "[DEBUG]: " },
+            { Color::WHITE, "[INFO]: " },
+            { Color::LIGHT_YELLOW, "[WARNING]: " },
+            { Color::LIGHT_RED, "[ERROR]: " },
+            { Color::RED, "[FATAL]: " },
+        };
+
+        inline const LevelStyle& StyleFor(LogLevel Level) {
+            return LevelStyles[static_cast<int>(Level)];
+        }
+
+        /**
+         * @brief Computes the filled width and percentage of a bar the same way the progress bar builders do.
+         */
+        inline void ProgressBucket(int Current, int Max, int BarWidth, int& FilledWidth, int& Percentage) {
+            if (Current > Max) {
+                Current = Max;
+            }
+            if (Current < 0) {
+                Current = 0;
+            }
+            double progress = (Max != 0) ? static_cast<double>(Current) / Max : 0.0;
+            FilledWidth = static_cast<int>(progress * BarWidth);
+            Percentage = static_cast<int>(progress * 100);
+        }
+
+        /**
+         * @brief Appends render inputs to a cache key. Strings are length-prefixed so fields cannot run together.
+         */
+        inline void AppendKeyField(std::string& Key, int Value) {
+            Key.append(reinterpret_cast<const char*>(&Value), sizeof(Value));
+        }
+
+        inline void AppendKeyField(std::string& Key, std::string_view Value) {
+            AppendKeyField(Key, static_cast<int>(Value.size()));
+            Key.append(Value);
+        }
+
+        /**
+         * @brief Returns the number of columns a FILL_AVAILABLE_WIDTH widget may use.
+         * The last column is left free so redraws with "\r" never trigger an automatic line wrap.
+         */
+        inline TerminalSize CurrentTerminalSize();
+
+        inline int AvailableColumns() {
+            return std::max(CurrentTerminalSize().Columns - 1, 0);
+        }
+
+        /**
+         * @brief Returns how many repeating units of UnitWidth columns fit next to FixedWidth columns of content.
+         */
+        inline int FillCount(int FixedWidth, int UnitWidth) {
+            return std::max((AvailableColumns() - FixedWidth) / std::max(UnitWidth, 1), 0);
+        }
+
+        /**
+         * @brief Resolves a FILL_AVAILABLE_WIDTH bar width for ProgressBar().
+         */
+        inline int ResolveBarWidth(int BarWidth, bool ShowPercentage) {
+            if (BarWidth != FILL_AVAILABLE_WIDTH) {
+                return BarWidth;
+            }
+            // Reserve room for " 100%" so the bar does not jump as the percentage grows.
+            return FillCount(ShowPercentage ? 5 : 0, 1);
+        }
+
+        /**
+         * @brief Resolves a FILL_AVAILABLE_WIDTH bar width for AdvancedProgressBar().
+         */
+        inline int ResolveBarWidth(int BarWidth,
+            std::string_view PrefixText,
+            std::string_view SuffixText,
+            std::string_view FillChar,
+            std::string_view UnfilledChar,
+            bool ShowPercentage,
+            bool ShowBrackets)
+        {
+            if (BarWidth != FILL_AVAILABLE_WIDTH) {
+                return BarWidth;
+            }
+            int fixedWidth = VisibleWidth(PrefixText)
+                + (ShowBrackets ? 2 : 0)
+                + (ShowPercentage ? 5 : 0)
+                + (SuffixText.empty() ? 0 : 1 + VisibleWidth(SuffixText));
+            return FillCount(fixedWidth, std::max(VisibleWidth(FillChar), VisibleWidth(UnfilledChar)));
+        }
+        /**
+         * @brief Appends a repeated string Count times.
+         */
+        template <typename String>
+        void AppendRepeated(String& Out, std::string_view Text, int Count) {
+            for (int i = 0; i < Count; i++) {
+                Out.append(Text);
+            }
+        }
+
+        // The builders below are written against any string type with append()/push_back(),
+        // so the std::string, std::pmr::string and buffer-based variants share one implementation.
+
+        template <typename String>
+        void AppendSpacing(String& Spacing, int NumberOfSpaces) {
+            CONSOLETOOLS_MEASURE_APPEND(Metric::Spacing, Spacing);
+            for (int i = 0; i < NumberOfSpaces; i++) {
+                Spacing.push_back('\n');
+            }
+        }
+
+        template <typename String>
+        void AppendHeader(String& Header,
+            std::string_view LineCharacter,
+            int LineCharacterCount,
+            std::string_view HeaderText,
+            std::string_view SpacingCharacter,
+            std::string_view LineColor,
+            std::string_view HeaderTextColor,
+            std::string_view SpacingCharacterColor)
+        {
+            CONSOLETOOLS_MEASURE_APPEND(Metric::Header, Header);
+            if (LineCharacterCount == FILL_AVAILABLE_WIDTH) {
+                LineCharacterCount = FillCount(VisibleWidth(HeaderText) + 2 * VisibleWidth(SpacingCharacter),
+                    2 * VisibleWidth(LineCharacter));
+            }
+
+            Header.append(LineColor);
+            AppendRepeated(Header, LineCharacter, LineCharacterCount);
+
+            Header.append(SpacingCharacterColor);
+            Header.append(SpacingCharacter);
+
+            Header.append(HeaderTextColor);
+            Header.append(HeaderText);
+
+            Header.append(SpacingCharacterColor);
+            Header.append(SpacingCharacter);
+
+            Header.append(LineColor);
+            AppendRepeated(Header, LineCharacter, LineCharacterCount);
+
+            Header.append(Color::RESET);
+        }
+
+        template <typename String>
+        void AppendAdvancedHeader(String& Header,
+            std::string_view LeftLineCharacter,
+            int LeftLineCharacterCount,
+            std::string_view RightLineCharacter,
+            int RightLineCharacterCount,
+            std::string_view HeaderText,
+            std::string_view SpacingCharacter,
+            std::string_view LeftLineColor,
+            std::string_view RightLineColor,
+            std::string_view HeaderTextColor,
+            std::string_view SpacingCharacterColor,
+            bool ResetColorOnEnd)
+        {
+            CONSOLETOOLS_MEASURE_APPEND(Metric::AdvancedHeader, Header);
+            bool fillLeft = LeftLineCharacterCount == FILL_AVAILABLE_WIDTH;
+            bool fillRight = RightLineCharacterCount == FILL_AVAILABLE_WIDTH;
+            if (fillLeft || fillRight) {
+                int leftWidth = VisibleWidth(LeftLineCharacter);
+                int rightWidth = VisibleWidth(RightLineCharacter);
+                int fixedWidth = VisibleWidth(HeaderText) + 2 * VisibleWidth(SpacingCharacter);
+
+                if (fillLeft && fillRight) {
+                    LeftLineCharacterCount = FillCount(fixedWidth, leftWidth + rightWidth);
+                    RightLineCharacterCount = LeftLineCharacterCount;
+                }
+                else if (fillLeft) {
+                    LeftLineCharacterCount = FillCount(fixedWidth + RightLineCharacterCount * rightWidth, leftWidth);
+                }
+                else {
+                    RightLineCharacterCount = FillCount(fixedWidth + LeftLineCharacterCount * leftWidth, rightWidth);
+                }
+            }
+
+            Header.append(LeftLineColor);
+            AppendRepeated(Header, LeftLineCharacter, LeftLineCharacterCount);
+
+            Header.append(SpacingCharacterColor);
+            Header.append(SpacingCharacter);
+
+            Header.append(HeaderTextColor);
+            Header.append(HeaderText);
+
+            Header.append(SpacingCharacterColor);
+            Header.append(SpacingCharacter);
+
+            Header.append(RightLineColor);
+            AppendRepeated(Header, RightLineCharacter, RightLineCharacterCount);
+
+            if (ResetColorOnEnd) {
+                Header.append(Color::RESET);
+            }
+        }
+
+        template <typename String>
+        void AppendProgressBar(String& Bar,
+            int CurrentProgress,
+            int MaxProgress,
+            int BarWidth,
+            std::string_view BarColor,
+            bool ShowPercentage,
+            std::string_view PercentageColor)
+        {
+            CONSOLETOOLS_MEASURE_APPEND(Metric::ProgressBar, Bar);
+            BarWidth = ResolveBarWidth(BarWidth, ShowPercentage);
+
+            // Clamp progress values to bounds
+            if (CurrentProgress > MaxProgress) {
+                CurrentProgress = MaxProgress;
+            }
+            if (CurrentProgress < 0) {
+                CurrentProgress = 0;
+            }
+
+            // Calculate progress fraction
+            double progress = static_cast<double>(CurrentProgress) / MaxProgress;
+            int filledWidth = static_cast<int>(progress * BarWidth);
+            int remainingWidth = BarWidth - filledWidth;
+
+            // Build the bar
+            Bar.append(BarColor);
+
+            // Filled portion
+            for (int i = 0; i < filledWidth; i++) {
+                Bar.push_back('#');
+            }
+            // Unfilled portion
+            for (int i = 0; i < remainingWidth; i++) {
+                Bar.push_back('-');
+            }
+
+            Bar.append(Color::RESET);
+
+            // Optionally show percentage
+            if (ShowPercentage) {
+                int percentage = static_cast<int>(progress * 100);
+                char digits[16];
+                int length = std::snprintf(digits, sizeof(digits), "%d", percentage);
+                Bar.push_back(' ');
+                Bar.append(PercentageColor);
+                Bar.append(std::string_view(digits, static_cast<std::size_t>(length)));
+                Bar.push_back('%');
+                Bar.append(Color::RESET);
+            }
+        }
+
+        template <typename String>
+        void AppendAdvancedProgressBar(String& Result,
+            int CurrentPercentage,
+            int MaxPercentage,
+            int BarWidth,
+            std::string_view PrefixText,
+            std::string_view SuffixText,
+            std::string_view FillChar,
+            std::string_view UnfilledChar,
+            std::string_view FillColor,
+            std::string_view UnfilledColor,
+            std::string_view TextColor,
+            std::string_view PrefixColor,
+            std::string_view SuffixColor,
+            std::string_view BracketColor,
+            bool ShowPercentage,
+            bool ShowBrackets,
+            bool ResetColorOnCompletion)
+        {
+            CONSOLETOOLS_MEASURE_APPEND(Metric::AdvancedProgressBar, Result);
+            BarWidth = ResolveBarWidth(BarWidth, PrefixText, SuffixText, FillChar, UnfilledChar,
+                ShowPercentage, ShowBrackets);
+
+            // Clamp current progress
+            if (CurrentPercentage < 0) {
+                CurrentPercentage = 0;
+            }
+            if (CurrentPercentage > MaxPercentage) {
+                CurrentPercentage = MaxPercentage;
+            }
+
+            // Calculate progress fraction, avoid divide-by-zero
+            double progress = (MaxPercentage != 0)
+                ? static_cast<double>(CurrentPercentage) / MaxPercentage
+                : 0.0;
+            int filledWidth = static_cast<int>(progress * BarWidth);
+            int remainingWidth = BarWidth - filledWidth;
+
+            // Prefix
+            if (!PrefixText.empty()) {
+                Result.append(PrefixColor);
+                Result.append(PrefixText);
+            }
+
+            // Optional brackets
+            if (ShowBrackets) {
+                Result.append(BracketColor);
+                Result.push_back('[');
+            }
+
+            // Filled portion
+            Result.append(FillColor);
+            AppendRepeated(Result, FillChar, filledWidth);
+
+            // Unfilled portion
+            Result.append(UnfilledColor);
+            AppendRepeated(Result, UnfilledChar, remainingWidth);
+
+            // Close brackets
+            if (ShowBrackets) {
+                Result.append(BracketColor);
+                Result.push_back(']');
+            }
+
+            // Show percentage
+            if (ShowPercentage) {
+                int percentageValue = static_cast<int>(progress * 100);
+                char digits[16];
+                int length = std::snprintf(digits, sizeof(digits), "%d", percentageValue);
+                Result.append(TextColor);
+                Result.push_back(' ');
+                Result.append(std::string_view(digits, static_cast<std::size_t>(length)));
+                Result.push_back('%');
+            }
+
+            // Suffix
+            if (!SuffixText.empty()) {
+                Result.push_back(' ');
+                Result.append(SuffixColor);
+                Result.append(SuffixText);
+            }
+
+            if (ResetColorOnCompletion) {
+                Result.append(Color::RESET);
+            }
+        }
+
+        template <typename String>
+        void AppendLevelMessage(String& Out, LogLevel Level, std::string_view Message) {
+            CONSOLETOOLS_MEASURE_APPEND(Level == LogLevel::Error ? Metric::Error : Metric::Warning, Out);
+            const LevelStyle& style = StyleFor(Level);
+            Out.reserve(Out.size() + style.Color.size() + style.Prefix.size() + Message.size());
+            Out.append(style.Color);
+            Out.append(style.Prefix);
+            Out.append(Message);
+        }
+
+        /**
+         * @brief Appends the bordered "[!] TYPE: " part of a notification, up to its text.
+         */
+        template <typename String>
+        void AppendNotificationPrefix(String& Notification,
+            std::string_view LeftBorderCharacter,
+            std::string_view InsideCharacter,
+            std::string_view RightBorderCharacter,
+            std::string_view NotificationTypeText,
+            std::string_view BorderCharacterColor,
+            std::string_view InsideCharacterColor)
+        {
+            Notification.append(BorderCharacterColor);
+            Notification.append(LeftBorderCharacter);
+
+            Notification.append(InsideCharacterColor);
+            Notification.append(InsideCharacter);
+
+            Notification.append(BorderCharacterColor);
+            Notification.append(RightBorderCharacter);
+
+            Notification.append(InsideCharacterColor);
+            Notification.push_back(' ');
+            Notification.append(NotificationTypeText);
+            Notification.append(": ");
+        }
+
+        template <typename String>
+        void AppendNotification(String& Notification,
+            std::string_view LeftBorderCharacter,
+            std::string_view InsideCharacter,
+            std::string_view RightBorderCharacter,
+            std::string_view NotificationTypeText,
+            std::string_view NotificationText,
+            std::string_view BorderCharacterColor,
+            std::string_view InsideCharacterColor,
+            std::string_view NotificationTextColor)
+        {
+            CONSOLETOOLS_MEASURE_APPEND(Metric::Notification, Notification);
+            AppendNotificationPrefix(Notification, LeftBorderCharacter, InsideCharacter, RightBorderCharacter,
+                NotificationTypeText, BorderCharacterColor, InsideCharacterColor);
+
+            Notification.append(NotificationTextColor);
+            Notification.append(NotificationText);
+
+            Notification.append(Color::RESET);
+        }
+
+        /**
+         * @brief Returns the generator behind PrintTypingTextEffect's delays, seeded randomly unless SeedTypingEffect() was called.
+         */
+        inline std::mt19937& TypingGenerator() {
+            static std::mt19937 generator(std::random_device{}());
+            return generator;
+        }
+
+        /**
+         * @brief Body of PrintTypingTextEffect. SleepUntil(deadline) returns false to cancel.
+         * @return true if the whole text was typed.
+         */
+        template <typename Sleeper>
+        bool TypeText(std::string_view Text, int MinDelayMilliseconds, int MaxDelayMilliseconds, Sleeper&& SleepUntil) {
+            std::mt19937& gen = TypingGenerator();
+            std::uniform_int_distribution<int> dist(MinDelayMilliseconds, MaxDelayMilliseconds);
+            Clock& clock = GetClock();
+
+            for (std::size_t i = 0; i < Text.size(); i++) {
+                int delay = dist(gen);
+                Print(Text.substr(i, 1));
+                FlushOutput();
+                if (!SleepUntil(clock.Now() + std::chrono::milliseconds(delay))) {
+                    // Leave the terminal with default colors on a fresh line.
+                    Print({ Color::RESET, Text[i] == '\n' ? "" : "\n" });
+                    FlushOutput();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Body of PrintSpinner. SleepUntil(deadline) returns false to cancel.
+         * @return true if the spinner ran for the full duration.
+         */
+        template <typename Sleeper>
+        bool Spin(int SpinDurationMs, int SpinSpeedMs, Sleeper&& SleepUntil) {
+            const SpinnerFrames& frames = Spinners::LINE;
+            int spinIndex = 0;
+            Clock& clock = GetClock();
+            auto start = clock.Now();
+
+            while (true) {
+                // Print spinning char and flush.
+                Print({ "\r", frames.Frames[spinIndex++] });
+                FlushOutput();
+                if (spinIndex == frames.Count) {
+                    spinIndex = 0;
+                }
+
+                if (!SleepUntil(clock.Now() + std::chrono::milliseconds(SpinSpeedMs))) {
+                    // Erase the spinner and leave the cursor at the start of the now empty line.
+                    Print({ "\r\033[2K", Color::RESET });
+                    FlushOutput();
+                    return false;
+                }
+                auto now = clock.Now();
+                if (std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() >= SpinDurationMs) {
+                    break;
+                }
+            }
+
+            // Clear the spinner character.
+            Print("\r \n");
+            FlushOutput();
+            return true;
+        }
+
+#if CONSOLETOOLS_HAS_STOP_TOKEN
+        /**
+         * @class StopWaiter
+         * @brief Sleeps on the current clock but wakes as soon as Stop is requested.
+         */
+        class StopWaiter {
+        public:
+            explicit StopWaiter(std::stop_token Stop)
+                : stop(std::move(Stop)),
+                callback(stop, Wake{ this })
+            {
+            }
+
+            /**
+             * @return false if Stop was requested before Deadline.
+             */
+            bool operator()(Clock::TimePoint Deadline) {
+                Clock& clock = GetClock();
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!stop.stop_requested() && clock.Now() < Deadline) {
+                    clock.WaitUntil(condition, lock, Deadline);
+                }
+                return !stop.stop_requested();
+            }
+
+        private:
+            struct Wake {
+                StopWaiter* Waiter;
+                void operator()() const {
+                    // Taking the lock means the waiter is either before its stop check or inside the wait.
+                    std::lock_guard<std::mutex> lock(Waiter->mutex);
+                    Waiter->condition.notify_all();
+                }
+            };
+
+            std::mutex mutex;
+            std::condition_variable_any condition;
+            std::stop_token stop;
+            std::stop_callback<Wake> callback;
+        };
+#endif
+    } // namespace detail
+
+    /**
+     * @brief Pauses the console until the user presses Enter.
+     * @param message A message printed before waiting for user input.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void PauseConsole(const std::string& message) {
+        Print({ message, "\n" });
+        FlushOutput();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+
+    /**
+     * @brief Creates a string consisting of line-break characters.
+     * @param NumberOfSpaces The number of newlines to append.
+     * @return A string containing the specified number of newline characters.
+     */
+    CONSOLETOOLS_INLINE std::string Spacing(int NumberOfSpaces) {
+        std::string spacing;
+        detail::AppendSpacing(spacing, NumberOfSpaces);
+        return spacing;
+    }
+
+    /**
+     * @brief Creates a header string with repeated line characters, spacing characters, and colored text.
+     * @param LineCharacter The character used to create the repeated line segments.
+     * @param LineCharacterCount The number of times to repeat the line character on each side, or FILL_AVAILABLE_WIDTH to span the terminal.
+     * @param HeaderText The text that appears in the center of the header.
+     * @param SpacingCharacter The character to insert between the line segments and the header text.
+     * @param LineColor The color code for the repeated line segments.
+     * @param HeaderTextColor The color code for the header text.
+     * @param SpacingCharacterColor The color code for the spacing character.
+     * @return The fully constructed header string.
+     */
+    CONSOLETOOLS_INLINE std::string Header(const std::string& LineCharacter,
+        int LineCharacterCount,
+        const std::string& HeaderText,
+        const std::string& SpacingCharacter,
+        const std::string& LineColor,
+        const std::string& HeaderTextColor,
+        const std::string& SpacingCharacterColor)
+    {
+        std::string header;
+        detail::AppendHeader(header, LineCharacter, LineCharacterCount, HeaderText, SpacingCharacter,
+            LineColor, HeaderTextColor, SpacingCharacterColor);
+        return header;
+    }
+
+    /**
+     * @brief Creates a header with two different line characters on the left and right, colored differently if desired.
+     * @param LeftLineCharacter Character repeated on the left side of the header.
+     * @param LeftLineCharacterCount Number of times to repeat the left line character, or FILL_AVAILABLE_WIDTH.
+     * @param RightLineCharacter Character repeated on the right side of the header.
+     * @param RightLineCharacterCount Number of times to repeat the right line character, or FILL_AVAILABLE_WIDTH.
+     * When both counts are FILL_AVAILABLE_WIDTH the remaining width is split evenly between the sides.
+     * @param HeaderText The text that appears in the center of the header.
+     * @param SpacingCharacter The character to insert between the line segments and the header text.
+     * @param LeftLineColor Color code for the left line segment.
+     * @param RightLineColor Color code for the right line segment.
+     * @param HeaderTextColor Color code for the header text.
+     * @param SpacingCharacterColor Color code for the spacing character.
+     * @param ResetColorOnEnd Whether to reset color codes at the end of the header.
+     * @return The fully constructed advanced header string.
+     */
+    CONSOLETOOLS_INLINE std::string AdvancedHeader(const std::string& LeftLineCharacter,
+        int LeftLineCharacterCount,
+        const std::string& RightLineCharacter,
+        int RightLineCharacterCount,
+        const std::string& HeaderText,
+        const std::string& SpacingCharacter,
+        const std::string& LeftLineColor,
+        const std::string& RightLineColor,
+        const std::string& HeaderTextColor,
+        const std::string& SpacingCharacterColor,
+        bool ResetColorOnEnd)
+    {
+        std::string header;
+        detail::AppendAdvancedHeader(header, LeftLineCharacter, LeftLineCharacterCount, RightLineCharacter,
+            RightLineCharacterCount, HeaderText, SpacingCharacter, LeftLineColor, RightLineColor,
+            HeaderTextColor, SpacingCharacterColor, ResetColorOnEnd);
+        return header;
+    }
+
+    /**
+     * @brief Creates a simple progress bar with a filled and unfilled portion, optionally showing a percentage.
+     * @param CurrentProgress The current progress value (must be <= MaxProgress).
+     * @param MaxProgress The maximum progress value.
+     * @param BarWidth The total width of the progress bar in characters, or FILL_AVAILABLE_WIDTH to span the terminal.
+     * @param BarColor The color code for the filled portion of the bar.
+     * @param ShowPercentage Whether to display the numeric percentage.
+     * @param PercentageColor The color code for the percentage display.
+     * @return The constructed progress bar string.
+     */
+    CONSOLETOOLS_INLINE std::string ProgressBar(int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        const std::string& BarColor,
+        bool ShowPercentage,
+        const std::string& PercentageColor)
+    {
+        std::string bar;
+        detail::AppendProgressBar(bar, CurrentProgress, MaxProgress, BarWidth, BarColor, ShowPercentage,
+            PercentageColor);
+        return bar;
+    }
+
+    /**
+     * @brief Creates an advanced progress bar with optional brackets, prefix/suffix text, custom fill/unfill characters, and colors.
+     * @param CurrentPercentage The current progress value.
+     * @param MaxPercentage The maximum progress value.
+     * @param BarWidth The total width of the progress bar in characters, or FILL_AVAILABLE_WIDTH to span the terminal.
+     * @param PrefixText A text that appears before the bar.
+     * @param SuffixText A text that appears after the bar.
+     * @param FillChar The character used to denote the filled portion of the bar.
+     * @param UnfilledChar The character used to denote the unfilled portion of the bar.
+     * @param FillColor The color code for the filled portion.
+     * @param UnfilledColor The color code for the unfilled portion.
+     * @param TextColor The color code for the percentage text.
+     * @param PrefixColor The color code for the prefix text.
+     * @param SuffixColor The color code for the suffix text.
+     * @param BracketColor The color code for the brackets.
+     * @param ShowPercentage Whether to display the numeric percentage next to the bar.
+     * @param ShowBrackets Whether to display brackets around the bar.
+     * @param ResetColorOnCompletion Whether to reset color codes after building the bar.
+     * @return The constructed advanced progress bar string.
+     */
+    CONSOLETOOLS_INLINE std::string AdvancedProgressBar(int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        const std::string& PrefixText,
+        const std::string& SuffixText,
+        const std::string& FillChar,
+        const std::string& UnfilledChar,
+        const std::string& FillColor,
+        const std::string& UnfilledColor,
+        const std::string& TextColor,
+        const std::string& PrefixColor,
+        const std::string& SuffixColor,
+        const std::string& BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion)
+    {
+        std::string result;
+        detail::AppendAdvancedProgressBar(result, CurrentPercentage, MaxPercentage, BarWidth, PrefixText,
+            SuffixText, FillChar, UnfilledChar, FillColor, UnfilledColor, TextColor, PrefixColor, SuffixColor,
+            BracketColor, ShowPercentage, ShowBrackets, ResetColorOnCompletion);
+        return result;
+    }
+
+    /**
+     * @brief Creates an error message string in red color.
+     * @param Message The error message to display.
+     * @return A colored error string prefixed with "[ERROR]: ".
+     */
+    CONSOLETOOLS_INLINE std::string Error(const std::string& Message) {
+        std::string error;
+        detail::AppendLevelMessage(error, LogLevel::Error, Message);
+        return error;
+    }
+
+    /**
+     * @brief Creates a warning message string in yellow color.
+     * @param Message The warning message to display.
+     * @return A colored warning string prefixed with "[WARNING]: ".
+     */
+    CONSOLETOOLS_INLINE std::string Warning(const std::string& Message) {
+        std::string warning;
+        detail::AppendLevelMessage(warning, LogLevel::Warning, Message);
+        return warning;
+    }
+
+    /**
+     * @brief Prints text to the console with a random delay between each character to simulate a typing effect.
+     * @param Text The text to print.
+     * @param MinDelayMilliseconds The minimum delay between characters in milliseconds.
+     * @param MaxDelayMilliseconds The maximum delay between characters in milliseconds.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void PrintTypingTextEffect(const std::string& Text,
+        int MinDelayMilliseconds,
+        int MaxDelayMilliseconds)
+    {
+        detail::TypeText(Text, MinDelayMilliseconds, MaxDelayMilliseconds, [](Clock::TimePoint Deadline) {
+            GetClock().SleepUntil(Deadline);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Creates a formatted notification string with a left border, an inside character, and a right border, along with some text.
+     * @param LeftBorderCharacter The character or string used as the left border.
+     * @param InsideCharacter The character or string used inside the border (often small).
+     * @param RightBorderCharacter The character or string used as the right border.
+     * @param NotificationTypeText A label or title for the notification (e.g., "INFO", "WARNING").
+     * @param NotificationText The main notification text to display.
+     * @param BorderCharacterColor Color code for the border characters.
+     * @param InsideCharacterColor Color code for the inside character.
+     * @param NotificationTextColor Color code for the notification text.
+     * @return A formatted notification string with optional coloring.
+     */
+    CONSOLETOOLS_INLINE std::string Notification(const std::string& LeftBorderCharacter,
+        const std::string& InsideCharacter,
+        const std::string& RightBorderCharacter,
+        const std::string& NotificationTypeText,
+        const std::string& NotificationText,
+        const std::string& BorderCharacterColor,
+        const std::string& InsideCharacterColor,
+        const std::string NotificationTextColor)
+    {
+        std::string notification;
+        detail::AppendNotification(notification, LeftBorderCharacter, InsideCharacter, RightBorderCharacter,
+            NotificationTypeText, NotificationText, BorderCharacterColor, InsideCharacterColor,
+            NotificationTextColor);
+        return notification;
+    }
+
+    /**
+     * @brief Prints a spinning animation in place for a specified duration, with a chosen spin speed.
+     * @param SpinDurationMs The total duration of the spinner in milliseconds.
+     * @param SpinSpeedMs The delay between spinner frames in milliseconds.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void PrintSpinner(int SpinDurationMs, int SpinSpeedMs) {
+        detail::Spin(SpinDurationMs, SpinSpeedMs, [](Clock::TimePoint Deadline) {
+            GetClock().SleepUntil(Deadline);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Prompts the user with a numbered menu of options and returns the users selection index (zero-based).
+     * @param Options A vector of strings representing the menu options.
+     * @param SeperatorCharacter The character (e.g. ':') separating the option index from the option text.
+     * @param PromptMessage A message displayed before listing the options.
+     * @param InputQuestionText A message asking the user to select an option.
+     * @param MessageColor Color code for the prompt message.
+     * @param NumberColor Color code for the numeric indices.
+     * @param SeperatorColor Color code for the separator character.
+     * @param OptionColor Color code for the option text.
+     * @param InputQuestionColor Color code for the question text prompting user input.
+     * @param ErrorColor Color code for any error messages (e.g., invalid input).
+     * @return The zero-based index of the users chosen option. Returns -1 if an error occurs or if no options are provided.
+     */
+    CONSOLETOOLS_INLINE int PromptNumberedMenu(const std::vector<std::string> Options,
+        const std::string SeperatorCharacter,
+        const std::string& PromptMessage,
+        const std::string InputQuestionText,
+        const std::string MessageColor,
+        const std::string NumberColor,
+        const std::string SeperatorColor,
+        const std::string OptionColor,
+        const std::string InputQuestionColor,
+        const std::string ErrorColor)
+    {
+        if (Options.empty()) {
+            std::cerr << "No menu options provided.\n";
+            return -1;
+        }
+
+        std::string menu;
+        menu.append(MessageColor);
+        menu.append(PromptMessage);
+        menu.append("\n");
+
+        // Print each option
+        for (size_t i = 0; i < Options.size(); i++) {
+            menu.append(NumberColor);
+            menu.append(std::to_string(i + 1));
+            menu.append(SeperatorColor);
+            menu.append(SeperatorCharacter);
+            menu.append(OptionColor);
+            menu.append(Options[i]);
+            menu.append(Color::RESET);
+            menu.append("\n");
+        }
+
+        // Ask for user input
+        menu.append(InputQuestionColor);
+        menu.append("\n");
+        menu.append(InputQuestionText);
+        menu.append(NumberColor);
+        Print(menu);
+        FlushOutput();
+
+        std::string input;
+        if (!std::getline(std::cin, input)) {
+            // Input read error
+            Print(ErrorColor);
+            FlushOutput();
+            std::cerr << "Input error. Exiting.\n";
+            Print(Color::RESET);
+            FlushOutput();
+            return -1;
+        }
+
+        // Convert the user input to an integer
+        try {
+            int choice = std::stoi(input);
+            if (choice < 1 || choice > static_cast<int>(Options.size())) {
+                // Out-of-range choice
+                std::string count = std::to_string(Options.size());
+                Print({ ErrorColor, "Invalid choice. Please enter a number between 1 and ", count, ".\n\n",
+                    Color::RESET });
+            }
+            else {
+                // Valid choice
+                Print(Color::RESET);
+                FlushOutput();
+                return choice - 1;
+            }
+        }
+        catch (const std::invalid_argument&) {
+            // Non-integer input
+            Print({ ErrorColor, "Invalid input. Please enter a numeric value.\n\n", Color::RESET });
+        }
+        catch (const std::out_of_range&) {
+            // Very large number that cannot fit in int
+            Print({ ErrorColor, "The number you entered is out of range. Please try again.\n\n", Color::RESET });
+        }
+
+        // If we reach here, the input was invalid.
+        Print(Color::RESET);
+        FlushOutput();
+        return -1;
+    }
+
+#if CONSOLETOOLS_HAS_STOP_TOKEN
+    /**
+     * @brief PauseConsole() that also returns as soon as Stop is requested.
+     * @param message A message printed before waiting for user input.
+     * @param Stop Cancels the wait. Anything typed so far is erased from the line and discarded from
+     * the terminal's input, so the next read does not receive it.
+     * @return true if the user pressed Enter, false if the wait was cancelled.
+     */
+    CONSOLETOOLS_INLINE bool PauseConsole(const std::string& message, std::stop_token Stop) {
+        Print({ message, "\n" });
+        FlushOutput();
+
+        bool pressed = false;
+#ifdef _WIN32
+        HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+        if (GetFileType(input) != FILE_TYPE_CHAR) {
+            // Redirected input cannot be polled here; fall back to the blocking wait.
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return true;
+        }
+        while (!Stop.stop_requested()) {
+            if (_kbhit()) {
+                int key = _getch();
+                if (key == '\r' || key == '\n') {
+                    pressed = true;
+                    break;
+                }
+            }
+            else {
+                Sleep(10);
+            }
+        }
+#else
+        if (std::cin.rdbuf()->in_avail() > 0) {
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return true;
+        }
+
+        int wake[2];
+        if (pipe(wake) != 0) {
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return true;
+        }
+        {
+            std::stop_callback wakeOnStop(Stop, [&wake]() {
+                char byte = 1;
+                ssize_t written = write(wake[1], &byte, 1);
+                (void)written;
+            });
+
+            while (!Stop.stop_requested()) {
+                struct pollfd descriptors[2] = { { STDIN_FILENO, POLLIN, 0 }, { wake[0], POLLIN, 0 } };
+                int ready = poll(descriptors, 2, -1);
+                if (ready < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    break;
+                }
+                if (descriptors[1].revents != 0) {
+                    break;
+                }
+                if (descriptors[0].revents != 0) {
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    pressed = true;
+                    break;
+                }
+            }
+        }
+        close(wake[0]);
+        close(wake[1]);
+#endif
+
+        if (!pressed) {
+            // Erasing the echo is not enough: the terminal still holds the typed bytes, and the next
+            // read would receive them.
+#ifdef _WIN32
+            FlushConsoleInputBuffer(input);
+#else
+            if (isatty(STDIN_FILENO)) {
+                tcflush(STDIN_FILENO, TCIFLUSH);
+            }
+#endif
+            Print({ "\r\033[2K", Color::RESET });
+            FlushOutput();
+        }
+        return pressed;
+    }
+
+    /**
+     * @brief PrintTypingTextEffect() that stops typing as soon as Stop is requested.
+     * @param Text The text to print.
+     * @param MinDelayMilliseconds The minimum delay between characters in milliseconds.
+     * @param MaxDelayMilliseconds The maximum delay between characters in milliseconds.
+     * @param Stop Cancels the effect. Colors are reset and the cursor moves to a new line.
+     * @return true if the whole text was typed, false if it was cancelled.
+     */
+    CONSOLETOOLS_INLINE bool PrintTypingTextEffect(const std::string& Text,
+        int MinDelayMilliseconds,
+        int MaxDelayMilliseconds,
+        std::stop_token Stop)
+    {
+        detail::StopWaiter waiter(std::move(Stop));
+        return detail::TypeText(Text, MinDelayMilliseconds, MaxDelayMilliseconds, waiter);
+    }
+
+    /**
+     * @brief PrintSpinner() that stops as soon as Stop is requested.
+     * @param SpinDurationMs The total duration of the spinner in milliseconds.
+     * @param SpinSpeedMs The delay between spinner frames in milliseconds.
+     * @param Stop Cancels the spinner. The line is erased and colors are reset.
+     * @return true if the spinner ran for the full duration, false if it was cancelled.
+     */
+    CONSOLETOOLS_INLINE bool PrintSpinner(int SpinDurationMs, int SpinSpeedMs, std::stop_token Stop) {
+        detail::StopWaiter waiter(std::move(Stop));
+        return detail::Spin(SpinDurationMs, SpinSpeedMs, waiter);
+    }
+#endif
+
+    /**
+     * @brief Returns the calling thread's scratch buffer used to assemble log messages.
+     * @return A reference to a thread-local string that keeps its capacity between calls.
+     */
+    CONSOLETOOLS_INLINE std::string& detail::ThreadLogBuffer() {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+    namespace detail {
+        /**
+         * @brief Returns how many Logger::Log() calls are assembling a message on this thread.
+         */
+        inline int& LogDepth() {
+            thread_local int depth = 0;
+            return depth;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Takes the thread's log buffer, or the scope's own buffer if an outer Log() call is using it.
+     */
+    CONSOLETOOLS_INLINE detail::LogBufferScope::LogBufferScope()
+        : buffer(LogDepth() == 0 ? &ThreadLogBuffer() : &fallback)
+    {
+        LogDepth()++;
+    }
+
+    CONSOLETOOLS_INLINE detail::LogBufferScope::~LogBufferScope() {
+        LogDepth()--;
+    }
+
+    /**
+     * @brief Creates a logger writing to the given stream, with every level enabled and timestamps shown.
+     * @param Output The stream that receives formatted log lines.
+     */
+    CONSOLETOOLS_INLINE Logger::Logger(std::ostream& Output)
+        : level(static_cast<int>(LogLevel::Trace)),
+        showTimestamps(true),
+        suppressor(nullptr),
+        output(&Output)
+    {
+    }
+
+    /**
+     * @brief Sets the lowest level that is printed at runtime.
+     * @param Level Messages below this level are discarded before any formatting happens.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Logger::SetLevel(LogLevel Level) {
+        level.store(static_cast<int>(Level), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the lowest level that is printed at runtime.
+     * @return The current runtime log level.
+     */
+    CONSOLETOOLS_INLINE LogLevel Logger::GetLevel() const {
+        return static_cast<LogLevel>(level.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Redirects log output to another stream.
+     * @param Output The stream that receives formatted log lines from now on.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Logger::SetOutput(std::ostream& Output) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        output = &Output;
+    }
+
+    /**
+     * @brief Enables or disables the "[HH:MM:SS.mmm]" timestamp in front of each line.
+     * @param ShowTimestamps Whether to print timestamps.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Logger::SetShowTimestamps(bool ShowTimestamps) {
+        showTimestamps.store(ShowTimestamps, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Routes messages through a suppressor so repeated templates are deduplicated and rate-limited.
+     * @param Suppressor The suppressor to consult before formatting, or nullptr to disable suppression.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Logger::SetSuppressor(MessageSuppressor* Suppressor) {
+        suppressor.store(Suppressor, std::memory_order_release);
+    }
+
+    /**
+     * @brief Formats and prints one log line, styled like Error() and Warning() and terminated with a color reset.
+     * @param Level The severity of the message.
+     * @param Message The already assembled message text.
+     * @param RepeatedCount How many identical messages were suppressed before this one.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Logger::Write(LogLevel Level, std::string_view Message, std::uint64_t RepeatedCount) {
+        CONSOLETOOLS_MEASURE(Metric::LogWrite);
+        thread_local std::string line;
+        line.clear();
+
+        if (showTimestamps.load(std::memory_order_relaxed)) {
+            auto now = std::chrono::system_clock::now();
+            std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+            int milliseconds = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                now.time_since_epoch()).count() % 1000);
+
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+            char stamp[32];
+            std::snprintf(stamp, sizeof(stamp), "[%02d:%02d:%02d.%03d] ",
+                local.tm_hour, local.tm_min, local.tm_sec, milliseconds);
+
+            line.append(Color::GRAY);
+            line.append(stamp);
+        }
+
+        const detail::LevelStyle& style = detail::StyleFor(Level);
+        line.append(style.Color);
+        line.append(style.Prefix);
+        line.append(Message);
+        if (RepeatedCount > 0) {
+            line.append(" (repeated ");
+            line.append(std::to_string(RepeatedCount));
+            line.append(" times)");
+        }
+        line.append(Color::RESET);
+        line.push_back('\n');
+        CONSOLETOOLS_MEASURE_BYTES(line.size());
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        output->write(line.data(), static_cast<std::streamsize>(line.size()));
+        output->flush();
+    }
+
+    /**
+     * @brief Creates a suppressor that lets each distinct message through at most MessagesPerSecond times per second.
+     * @param MessagesPerSecond The sustained rate allowed for each message template.
+     * @param BurstSize How many copies of a message may pass back-to-back before limiting kicks in.
+     */
+    CONSOLETOOLS_INLINE MessageSuppressor::MessageSuppressor(double MessagesPerSecond, int BurstSize)
+        : emissionInterval(static_cast<std::int64_t>(1e9 / (MessagesPerSecond > 0.0 ? MessagesPerSecond : 1.0))),
+        burstTolerance(emissionInterval * (BurstSize > 1 ? BurstSize - 1 : 0)),
+        slots(new Slot[SlotCount])
+    {
+        overflow.text = "Other messages";
+    }
+
+    /**
+     * @brief Finds the table slot for a message, claiming one within a bounded run of linear probing if
+     * the message has none. The slot is returned with a reader registered in its control word, so
+     * its text cannot change until the caller releases it.
+     * @param Key The hash of the message template.
+     * @param Template The template text, compared on a hash match and copied when a slot is claimed.
+     * @param Now The current time in nanoseconds.
+     * @return The slot for the message, or nullptr if every slot in the run is in use.
+     */
+    CONSOLETOOLS_INLINE MessageSuppressor::Slot* MessageSuppressor::FindSlot(std::uint64_t Key, std::string_view Template,
+        std::int64_t Now)
+    {
+        constexpr std::size_t maxProbes = 16;
+        for (int attempt = 0; attempt < 2; attempt++) {
+            Slot* reusable = nullptr;
+            std::uint32_t reusableState = Empty;
+            for (std::size_t probe = 0; probe < maxProbes; probe++) {
+                Slot& slot = slots[(Key + probe) % SlotCount];
+                std::uint32_t state = slot.control.fetch_add(1, std::memory_order_acquire) / StateUnit;
+                while (state == Claiming) {
+                    // Another thread is claiming this slot, perhaps for the same message: wait for it
+                    // rather than take a second slot. Claims only copy the template.
+                    slot.control.fetch_sub(1, std::memory_order_release);
+                    std::this_thread::yield();
+                    state = slot.control.fetch_add(1, std::memory_order_acquire) / StateUnit;
+                }
+
+                if (state == Live) {
+                    if (slot.key.load(std::memory_order_relaxed) == Key && slot.text == Template) {
+                        return &slot;
+                    }
+                    // A refilled bucket with nothing left to report behaves exactly like a fresh one.
+                    bool stale = slot.theoreticalArrival.load(std::memory_order_relaxed) <= Now
+                        && slot.suppressed.load(std::memory_order_relaxed) == 0;
+                    if (reusable == nullptr && stale) {
+                        reusable = &slot;
+                        reusableState = Live;
+                    }
+                }
+                slot.control.fetch_sub(1, std::memory_order_release);
+
+                if (state == Empty) {
+                    // Slots are filled in probe order and never emptied, so the message is not further on.
+                    if (reusable == nullptr) {
+                        reusable = &slot;
+                        reusableState = Empty;
+                    }
+                    break;
+                }
+            }
+
+            if (reusable != nullptr && Claim(*reusable, reusableState, Key, Template, Now)) {
+                return reusable;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Takes over a slot for a new message, if it is still empty or stale and nobody reads it.
+     * On success the slot is Live with the caller registered as a reader.
+     * @param Target The slot to claim.
+     * @param Expected The state the slot was seen in (Empty or Live).
+     * @param Key The hash of the message template.
+     * @param Template The template text.
+     * @param Now The current time in nanoseconds.
+     * @return true if the slot now belongs to the message.
+     */
+    CONSOLETOOLS_INLINE bool MessageSuppressor::Claim(Slot& Target, std::uint32_t Expected, std::uint64_t Key,
+        std::string_view Template, std::int64_t Now)
+    {
+        std::uint32_t control = Expected * StateUnit;
+        if (!Target.control.compare_exchange_strong(control, Claiming * StateUnit, std::memory_order_acquire)) {
+            return false;
+        }
+        if (Expected == Live && (Target.theoreticalArrival.load(std::memory_order_relaxed) > Now
+            || Target.suppressed.load(std::memory_order_relaxed) != 0))
+        {
+            // Used again between the look and the claim.
+            Target.control.fetch_add((Live - Claiming) * StateUnit, std::memory_order_release);
+            return false;
+        }
+
+        Target.key.store(Key, std::memory_order_relaxed);
+        Target.text.assign(Template);
+        Target.theoreticalArrival.store(0, std::memory_order_relaxed);
+        Target.suppressed.store(0, std::memory_order_relaxed);
+        // Readers that looked while it was Claiming have backed out again; their counts stay balanced.
+        Target.control.fetch_add((Live - Claiming) * StateUnit + 1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    /**
+     * @brief Decides whether a message may be printed now.
+     * @param Template The message template; identical templates share one token bucket.
+     * @param RepeatedCount Receives the number of copies suppressed since the last allowed one.
+     * @return true if the message should be printed, false if it was counted and suppressed.
+     */
+    CONSOLETOOLS_INLINE bool MessageSuppressor::Allow(std::string_view Template, std::uint64_t& RepeatedCount) {
+        RepeatedCount = 0;
+
+        std::uint64_t key = detail::Fnv1a(Template);
+        std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            GetClock().Now().time_since_epoch()).count();
+
+        Slot* slot = FindSlot(key, Template, now);
+        bool overflowed = slot == nullptr;
+        if (overflowed) {
+            slot = &overflow;
+        }
+
+        bool allowed = true;
+        std::int64_t arrival = slot->theoreticalArrival.load(std::memory_order_relaxed);
+        while (true) {
+            std::int64_t start = std::max(arrival, now);
+            if (start - now > burstTolerance) {
+                slot->suppressed.fetch_add(1, std::memory_order_relaxed);
+                allowed = false;
+                break;
+            }
+            if (slot->theoreticalArrival.compare_exchange_weak(arrival, start + emissionInterval,
+                std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        // Copies suppressed in the overflow bucket were other messages, so only TakeSummaries() reports them.
+        if (!overflowed) {
+            if (allowed) {
+                RepeatedCount = slot->suppressed.exchange(0, std::memory_order_relaxed);
+            }
+            slot->control.fetch_sub(1, std::memory_order_release);
+        }
+        return allowed;
+    }
+
+    /**
+     * @brief Filters a message through the suppressor.
+     * @param Message The message to print.
+     * @return An empty string if the message is suppressed, otherwise the message with a
+     * " (repeated N times)" suffix when earlier copies were suppressed.
+     */
+    CONSOLETOOLS_INLINE std::string MessageSuppressor::Filter(const std::string& Message) {
+        std::uint64_t repeatedCount = 0;
+        if (!Allow(Message, repeatedCount)) {
+            return std::string();
+        }
+
+        std::string filtered = Message;
+        if (repeatedCount > 0) {
+            filtered.append(" (repeated ");
+            filtered.append(std::to_string(repeatedCount));
+            filtered.append(" times)");
+        }
+        return filtered;
+    }
+
+    /**
+     * @brief Collects the messages that still have suppressed copies, so the tail of a burst is not lost.
+     * @return One "message (repeated N times)" line per template with pending suppressed copies.
+     */
+    CONSOLETOOLS_INLINE std::vector<std::string> MessageSuppressor::TakeSummaries() {
+        std::vector<std::string> summaries;
+        auto take = [&summaries](Slot& Target) {
+            std::uint64_t suppressed = Target.suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed > 0) {
+                summaries.push_back(Target.text + " (repeated " + std::to_string(suppressed) + " times)");
+            }
+        };
+        for (std::size_t i = 0; i < SlotCount; i++) {
+            Slot& slot = slots[i];
+            if (slot.control.fetch_add(1, std::memory_order_acquire) / StateUnit == Live) {
+                take(slot);
+            }
+            slot.control.fetch_sub(1, std::memory_order_release);
+        }
+        take(overflow);
+        return summaries;
+    }
+
+    /**
+     * @brief Returns the process-wide suppressor used by RateLimitedWarning().
+     * @return A suppressor allowing each message 5 times per second with bursts of 10.
+     */
+    CONSOLETOOLS_INLINE MessageSuppressor& DefaultSuppressor() {
+        static MessageSuppressor suppressor(5.0, 10);
+        return suppressor;
+    }
+
+    /**
+     * @brief Creates a warning message string like Warning(), but deduplicated and rate-limited.
+     * @param Message The warning message to display.
+     * @return The warning string, or an empty string if this message is currently being suppressed.
+     */
+    CONSOLETOOLS_INLINE std::string RateLimitedWarning(const std::string& Message) {
+        std::string filtered = DefaultSuppressor().Filter(Message);
+        if (filtered.empty()) {
+            return filtered;
+        }
+        return Warning(filtered);
+    }
+
+    /**
+     * @brief Returns the process-wide logger used by the CONSOLETOOLS_LOG_* macros.
+     * @return A logger that writes to std::cerr.
+     */
+    CONSOLETOOLS_INLINE Logger& DefaultLogger() {
+        static Logger logger(std::cerr);
+        return logger;
+    }
+
+    /**
+     * @brief Creates an empty render cache.
+     * @param Capacity The maximum number of rendered strings kept before the least recently used is evicted.
+     */
+    CONSOLETOOLS_INLINE RenderCache::RenderCache(std::size_t Capacity)
+        : capacity(Capacity > 0 ? Capacity : 1)
+    {
+    }
+
+    /**
+     * @brief Looks up a previously rendered string and marks it as most recently used.
+     * @param Hash The hash of Key.
+     * @param Key The encoded render inputs.
+     * @return A pointer to the cached string, or nullptr on a miss.
+     */
+    CONSOLETOOLS_INLINE const std::string* RenderCache::Find(std::uint64_t Hash, std::string_view Key) {
+        auto found = index.find(Hash);
+        if (found == index.end() || found->second->Key != Key) {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        entries.splice(entries.begin(), entries, found->second);
+        return &found->second->Rendered;
+    }
+
+    /**
+     * @brief Stores a rendered string, evicting the least recently used entry when full.
+     * @param Hash The hash of Key.
+     * @param Key The encoded render inputs.
+     * @param Rendered The rendered output for these inputs.
+     * @return A reference to the stored string, valid until it is evicted.
+     */
+    CONSOLETOOLS_INLINE const std::string& RenderCache::Store(std::uint64_t Hash, std::string_view Key, std::string Rendered) {
+        auto found = index.find(Hash);
+        if (found != index.end()) {
+            // Hash collision or refresh: overwrite in place.
+            entries.splice(entries.begin(), entries, found->second);
+        }
+        else if (index.size() >= capacity) {
+            // Recycle the oldest node so its string buffers are reused.
+            auto oldest = std::prev(entries.end());
+            index.erase(oldest->Hash);
+            entries.splice(entries.begin(), entries, oldest);
+            index.emplace(Hash, entries.begin());
+        }
+        else {
+            entries.emplace_front();
+            index.emplace(Hash, entries.begin());
+        }
+
+        Entry& entry = entries.front();
+        entry.Hash = Hash;
+        entry.Key.assign(Key);
+        entry.Rendered = std::move(Rendered);
+        return entry.Rendered;
+    }
+
+    /**
+     * @brief Changes the maximum number of entries, evicting old entries if needed.
+     * @param Capacity The new capacity (at least 1).
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void RenderCache::SetCapacity(std::size_t Capacity) {
+        capacity = Capacity > 0 ? Capacity : 1;
+        while (index.size() > capacity) {
+            index.erase(entries.back().Hash);
+            entries.pop_back();
+        }
+    }
+
+    /**
+     * @brief Removes every cached entry.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void RenderCache::Clear() {
+        entries.clear();
+        index.clear();
+    }
+
+    /**
+     * @brief Returns the calling thread's render cache used by the Cached* builders.
+     * @return A thread-local cache holding up to 1024 rendered strings.
+     */
+    CONSOLETOOLS_INLINE RenderCache& ThreadRenderCache() {
+        thread_local RenderCache cache(1024);
+        return cache;
+    }
+
+    /**
+     * @brief Same as ProgressBar(), but returns a cached string when an identical bar was rendered before.
+     * Inputs that produce the same filled width and percentage share one cache entry.
+     * @return A reference into the thread's render cache, valid until the next Cached* call on this thread.
+     */
+    CONSOLETOOLS_INLINE const std::string& CachedProgressBar(int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        const std::string& BarColor,
+        bool ShowPercentage,
+        const std::string& PercentageColor)
+    {
+        CONSOLETOOLS_MEASURE(Metric::CachedProgressBar);
+        BarWidth = detail::ResolveBarWidth(BarWidth, ShowPercentage);
+
+        int filledWidth = 0;
+        int percentage = 0;
+        detail::ProgressBucket(CurrentProgress, MaxProgress, BarWidth, filledWidth, percentage);
+
+        thread_local std::string key;
+        key.clear();
+        key.push_back('P');
+        detail::AppendKeyField(key, BarWidth);
+        detail::AppendKeyField(key, filledWidth);
+        detail::AppendKeyField(key, ShowPercentage ? percentage : -1);
+        detail::AppendKeyField(key, BarColor);
+        detail::AppendKeyField(key, PercentageColor);
+
+        RenderCache& cache = ThreadRenderCache();
+        std::uint64_t hash = detail::Fnv1a(key);
+        const std::string* cached = cache.Find(hash, key);
+        const std::string& result = cached ? *cached : cache.Store(hash, key,
+            ProgressBar(CurrentProgress, MaxProgress, BarWidth, BarColor, ShowPercentage, PercentageColor));
+        CONSOLETOOLS_MEASURE_BYTES(result.size());
+        return result;
+    }
+
+    /**
+     * @brief Same as AdvancedProgressBar(), but returns a cached string when an identical bar was rendered before.
+     * Inputs that produce the same filled width and percentage share one cache entry.
+     * @return A reference into the thread's render cache, valid until the next Cached* call on this thread.
+     */
+    CONSOLETOOLS_INLINE const std::string& CachedAdvancedProgressBar(int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        const std::string& PrefixText,
+        const std::string& SuffixText,
+        const std::string& FillChar,
+        const std::string& UnfilledChar,
+        const std::string& FillColor,
+        const std::string& UnfilledColor,
+        const std::string& TextColor,
+        const std::string& PrefixColor,
+        const std::string& SuffixColor,
+        const std::string& BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion)
+    {
+        CONSOLETOOLS_MEASURE(Metric::CachedAdvancedProgressBar);
+        BarWidth = detail::ResolveBarWidth(BarWidth, PrefixText, SuffixText, FillChar, UnfilledChar,
+            ShowPercentage, ShowBrackets);
+
+        int filledWidth = 0;
+        int percentage = 0;
+        detail::ProgressBucket(CurrentPercentage, MaxPercentage, BarWidth, filledWidth, percentage);
+
+        thread_local std::string key;
+        key.clear();
+        key.push_back('A');
+        detail::AppendKeyField(key, BarWidth);
+        detail::AppendKeyField(key, filledWidth);
+        detail::AppendKeyField(key, ShowPercentage ? percentage : -1);
+        detail::AppendKeyField(key, (ShowBrackets ? 1 : 0) | (ResetColorOnCompletion ? 2 : 0));
+        detail::AppendKeyField(key, PrefixText);
+        detail::AppendKeyField(key, SuffixText);
+        detail::AppendKeyField(key, FillChar);
+        detail::AppendKeyField(key, UnfilledChar);
+        detail::AppendKeyField(key, FillColor);
+        detail::AppendKeyField(key, UnfilledColor);
+        detail::AppendKeyField(key, TextColor);
+        detail::AppendKeyField(key, PrefixColor);
+        detail::AppendKeyField(key, SuffixColor);
+        detail::AppendKeyField(key, BracketColor);
+
+        RenderCache& cache = ThreadRenderCache();
+        std::uint64_t hash = detail::Fnv1a(key);
+        const std::string* cached = cache.Find(hash, key);
+        const std::string& result = cached ? *cached : cache.Store(hash, key,
+            AdvancedProgressBar(CurrentPercentage, MaxPercentage, BarWidth, PrefixText, SuffixText,
+                FillChar, UnfilledChar, FillColor, UnfilledColor, TextColor, PrefixColor, SuffixColor,
+                BracketColor, ShowPercentage, ShowBrackets, ResetColorOnCompletion));
+        CONSOLETOOLS_MEASURE_BYTES(result.size());
+        return result;
+    }
+
+    namespace detail {
+        /**
+         * @struct TerminalSizeState
+         * @brief Cached terminal size plus the SIGWINCH self-pipe and the thread that services it.
+         */
+        struct TerminalSizeState {
+            std::atomic<int> columns{ 0 };
+            std::atomic<int> rows{ 0 };
+            std::atomic<std::uint64_t> generation{ 0 };
+            std::atomic<std::int64_t> lastQuery{ 0 };
+            std::atomic<bool> watching{ false };
+            std::mutex watcherMutex;
+            std::thread watcher;
+#ifndef _WIN32
+            int wakePipe[2] = { -1, -1 };
+#endif
+
+            ~TerminalSizeState() {
+                StopTerminalResizeWatcher();
+            }
+        };
+
+        inline TerminalSizeState& SizeState() {
+            static TerminalSizeState state;
+            return state;
+        }
+
+#ifndef _WIN32
+        // Written by the signal handler, so it must be a plain lock-free atomic.
+        inline std::atomic<int> ResizeWakeFd{ -1 };
+        inline struct sigaction PreviousResizeAction = {};
+
+        inline void OnResizeSignal(int Signal, siginfo_t* Info, void* Context) {
+            int savedErrno = errno;
+            int fd = ResizeWakeFd.load(std::memory_order_relaxed);
+            if (fd >= 0) {
+                char byte = 'r';
+                [[maybe_unused]] ssize_t written = write(fd, &byte, 1);
+            }
+            errno = savedErrno;
+
+            const struct sigaction& previous = PreviousResizeAction;
+            if (previous.sa_flags & SA_SIGINFO) {
+                previous.sa_sigaction(Signal, Info, Context);
+            }
+            else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+                previous.sa_handler(Signal);
+            }
+        }
+#endif
+
+        /**
+         * @brief Asks the operating system for the current terminal size.
+         * Falls back to $COLUMNS/$LINES and then to 80x24 when no terminal is attached.
+         */
+        inline TerminalSize QueryTerminalSize() {
+            TerminalSize size{ 0, 0 };
+#ifdef _WIN32
+            CONSOLE_SCREEN_BUFFER_INFO info;
+            if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+                size.Columns = info.srWindow.Right - info.srWindow.Left + 1;
+                size.Rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+            }
+#else
+            struct winsize window {};
+            for (int fd : { STDOUT_FILENO, STDERR_FILENO, STDIN_FILENO }) {
+                if (ioctl(fd, TIOCGWINSZ, &window) == 0 && window.ws_col > 0) {
+                    size.Columns = window.ws_col;
+                    size.Rows = window.ws_row;
+                    break;
+                }
+            }
+#endif
+            if (size.Columns <= 0) {
+                const char* columns = std::getenv("COLUMNS");
+                size.Columns = (columns != nullptr) ? std::atoi(columns) : 0;
+            }
+            if (size.Rows <= 0) {
+                const char* lines = std::getenv("LINES");
+                size.Rows = (lines != nullptr) ? std::atoi(lines) : 0;
+            }
+            if (size.Columns <= 0) {
+                size.Columns = 80;
+            }
+            if (size.Rows <= 0) {
+                size.Rows = 24;
+            }
+            return size;
+        }
+
+        /**
+         * @brief Decodes one UTF-8 sequence starting at Index and advances Index past it.
+         * Invalid bytes decode as U+FFFD and consume a single byte.
+         */
+        constexpr char32_t DecodeUtf8(std::string_view Text, std::size_t& Index) {
+            unsigned char lead = static_cast<unsigned char>(Text[Index]);
+            int length = (lead < 0x80) ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+            if (length == 0 || Index + length > Text.size()) {
+                Index++;
+                return 0xFFFD;
+            }
+
+            char32_t codepoint = (length == 1) ? lead : (lead & (0x7F >> length));
+            for (int i = 1; i < length; i++) {
+                unsigned char next = static_cast<unsigned char>(Text[Index + i]);
+                if ((next & 0xC0) != 0x80) {
+                    Index++;
+                    return 0xFFFD;
+                }
+                codepoint = (codepoint << 6) | (next & 0x3F);
+            }
+            Index += length;
+            return codepoint;
+        }
+
+        /**
+         * @brief Returns how many terminal columns a codepoint occupies (0 for controls and combining marks, 2 for wide characters).
+         */
+        constexpr int CodepointWidth(char32_t Codepoint) {
+            if (Codepoint < 0x20 || (Codepoint >= 0x7F && Codepoint < 0xA0)) {
+                return 0;
+            }
+            if ((Codepoint >= 0x0300 && Codepoint <= 0x036F) || (Codepoint >= 0x200B && Codepoint <= 0x200F)
+                || (Codepoint >= 0xFE00 && Codepoint <= 0xFE0F))
+            {
+                return 0;
+            }
+            if ((Codepoint >= 0x1100 && Codepoint <= 0x115F) || (Codepoint >= 0x2E80 && Codepoint <= 0xA4CF)
+                || (Codepoint >= 0xAC00 && Codepoint <= 0xD7A3) || (Codepoint >= 0xF900 && Codepoint <= 0xFAFF)
+                || (Codepoint >= 0xFE30 && Codepoint <= 0xFE4F) || (Codepoint >= 0xFF00 && Codepoint <= 0xFF60)
+                || (Codepoint >= 0xFFE0 && Codepoint <= 0xFFE6) || (Codepoint >= 0x1F300 && Codepoint <= 0x1F64F)
+                || (Codepoint >= 0x1F900 && Codepoint <= 0x1F9FF) || (Codepoint >= 0x20000 && Codepoint <= 0x3FFFD))
+            {
+                return 2;
+            }
+            return 1;
+        }
+
+        /**
+         * @brief Returns the length of the ANSI escape sequence starting at Index (which must be ESC).
+         */
+        constexpr std::size_t EscapeSequenceLength(std::string_view Text, std::size_t Index) {
+            std::size_t i = Index + 1;
+            if (i >= Text.size()) {
+                return 1;
+            }
+            if (Text[i] == '[') {
+                // CSI: parameters and intermediates, then a final byte in 0x40..0x7E
+                for (i++; i < Text.size(); i++) {
+                    if (Text[i] >= 0x40 && Text[i] <= 0x7E) {
+                        return i - Index + 1;
+                    }
+                }
+                return Text.size() - Index;
+            }
+            if (Text[i] == ']') {
+                // OSC: terminated by BEL or ST (ESC \)
+                for (i++; i < Text.size(); i++) {
+                    if (Text[i] == '\a') {
+                        return i - Index + 1;
+                    }
+                    if (Text[i] == '\033' && i + 1 < Text.size() && Text[i + 1] == '\\') {
+                        return i - Index + 2;
+                    }
+                }
+                return Text.size() - Index;
+            }
+            return 2;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Returns the cached terminal size, querying the terminal on first use.
+     * The value is refreshed by the resize watcher (see StartTerminalResizeWatcher()) or RefreshTerminalSize().
+     * @return The terminal width and height in character cells.
+     */
+    CONSOLETOOLS_INLINE TerminalSize GetTerminalSize() {
+        detail::TerminalSizeState& state = detail::SizeState();
+        int columns = state.columns.load(std::memory_order_relaxed);
+        if (columns == 0) {
+            return RefreshTerminalSize();
+        }
+        return TerminalSize{ columns, state.rows.load(std::memory_order_relaxed) };
+    }
+
+    /**
+     * @brief Queries the terminal size again and updates the cache, bumping the generation if it changed.
+     * @return The current terminal width and height in character cells.
+     */
+    CONSOLETOOLS_INLINE TerminalSize RefreshTerminalSize() {
+        detail::TerminalSizeState& state = detail::SizeState();
+        TerminalSize size = detail::QueryTerminalSize();
+        int previousColumns = state.columns.exchange(size.Columns, std::memory_order_relaxed);
+        int previousRows = state.rows.exchange(size.Rows, std::memory_order_relaxed);
+        if (previousColumns != size.Columns || previousRows != size.Rows) {
+            state.generation.fetch_add(1, std::memory_order_release);
+        }
+        return size;
+    }
+
+    /**
+     * @brief Returns a counter that increases every time the terminal size changes.
+     * Widgets can remember it and recompute their layout only when it differs.
+     * @return The current terminal size generation.
+     */
+    CONSOLETOOLS_INLINE std::uint64_t TerminalSizeGeneration() {
+        return detail::SizeState().generation.load(std::memory_order_acquire);
+    }
+
+    namespace detail {
+        /**
+         * @brief The terminal size used for FILL_AVAILABLE_WIDTH. Builders never start the resize watcher:
+         * while it is not running, the size is queried again at most every 250 ms instead.
+         */
+        inline TerminalSize CurrentTerminalSize() {
+            TerminalSizeState& state = SizeState();
+            if (state.watching.load(std::memory_order_acquire)) {
+                return GetTerminalSize();
+            }
+
+            std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            std::int64_t last = state.lastQuery.load(std::memory_order_relaxed);
+            constexpr std::int64_t refreshInterval = 250'000'000;
+            if ((last == 0 || now - last >= refreshInterval)
+                && state.lastQuery.compare_exchange_strong(last, now, std::memory_order_relaxed))
+            {
+                return RefreshTerminalSize();
+            }
+            return GetTerminalSize();
+        }
+    } // namespace detail
+
+    /**
+     * @brief Installs a SIGWINCH handler that keeps GetTerminalSize() up to date in the background.
+     * The handler only writes a byte to a self-pipe; a helper thread performs the ioctl. Any previously
+     * installed SIGWINCH handler, plain or SA_SIGINFO, is still called. Safe to call repeatedly.
+     * Nothing starts the watcher implicitly.
+     * @return true if the watcher is running, false if resize notifications are unavailable on this platform.
+     */
+    CONSOLETOOLS_INLINE bool StartTerminalResizeWatcher() {
+        detail::TerminalSizeState& state = detail::SizeState();
+        if (state.watching.load(std::memory_order_acquire)) {
+            return true;
+        }
+#ifdef _WIN32
+        return false;
+#else
+        std::lock_guard<std::mutex> lock(state.watcherMutex);
+        if (state.watching.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        if (pipe(state.wakePipe) != 0) {
+            return false;
+        }
+        for (int fd : state.wakePipe) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        fcntl(state.wakePipe[1], F_SETFL, O_NONBLOCK);
+
+        int readFd = state.wakePipe[0];
+        state.watcher = std::thread([readFd]() {
+            char bytes[64];
+            while (true) {
+                ssize_t count = read(readFd, bytes, sizeof(bytes));
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0 || std::memchr(bytes, 'q', static_cast<std::size_t>(count)) != nullptr) {
+                    break;
+                }
+                RefreshTerminalSize();
+            }
+        });
+
+        detail::ResizeWakeFd.store(state.wakePipe[1], std::memory_order_relaxed);
+
+        struct sigaction action {};
+        action.sa_sigaction = detail::OnResizeSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigaction(SIGWINCH, &action, &detail::PreviousResizeAction);
+
+        RefreshTerminalSize();
+        state.watching.store(true, std::memory_order_release);
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Removes the SIGWINCH handler and stops the resize watcher thread.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void StopTerminalResizeWatcher() {
+#ifndef _WIN32
+        detail::TerminalSizeState& state = detail::SizeState();
+        std::lock_guard<std::mutex> lock(state.watcherMutex);
+        if (!state.watching.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        sigaction(SIGWINCH, &detail::PreviousResizeAction, nullptr);
+        detail::ResizeWakeFd.store(-1, std::memory_order_relaxed);
+
+        char quit = 'q';
+        while (write(state.wakePipe[1], &quit, 1) < 0 && errno == EINTR) {
+        }
+        state.watcher.join();
+
+        close(state.wakePipe[0]);
+        close(state.wakePipe[1]);
+        state.wakePipe[0] = state.wakePipe[1] = -1;
+        state.watching.store(false, std::memory_order_release);
+#endif
+    }
+
+    /**
+     * @brief Returns how many terminal columns a string occupies when printed.
+     * ANSI escape sequences take no space, and UTF-8 text is measured per codepoint
+     * (wide CJK/emoji characters count as two columns, combining marks as zero).
+     * @param Text The text to measure.
+     * @return The display width in columns.
+     */
+    CONSOLETOOLS_INLINE CONSOLETOOLS_CONSTEXPR int VisibleWidth(std::string_view Text) {
+        int width = 0;
+        std::size_t i = 0;
+        while (i < Text.size()) {
+            if (Text[i] == '\033') {
+                i += detail::EscapeSequenceLength(Text, i);
+            }
+            else if (static_cast<unsigned char>(Text[i]) < 0x80) {
+                width += (Text[i] >= 0x20 && Text[i] != 0x7F) ? 1 : 0;
+                i++;
+            }
+            else {
+                width += detail::CodepointWidth(detail::DecodeUtf8(Text, i));
+            }
+        }
+        return width;
+    }
+
+    namespace detail {
+        /**
+         * @struct RestoreSequence
+         * @brief Bytes that undo the current terminal modes, formatted ahead of time for the signal handler.
+         */
+        struct RestoreSequence {
+            char Bytes[64];
+            std::size_t Size;
+        };
+
+#ifndef _WIN32
+        /**
+         * @struct SavedDescriptorFlags
+         * @brief File status flags of a descriptor that a FileDescriptorSink made non-blocking.
+         * Descriptor is -1 while the entry is free and -2 while it is being claimed; Flags is valid
+         * once Descriptor holds a real descriptor.
+         */
+        struct SavedDescriptorFlags {
+            std::atomic<int> Descriptor{ -1 };
+            std::atomic<int> Flags{ 0 };
+        };
+#endif
+
+        /**
+         * @struct TerminalModeState
+         * @brief Which modes ConsoleTools changed, and the restore sequence the signal handler writes.
+         *
+         * Two sequences are kept so a new one can be formatted while the handler may be reading the
+         * published one; publishing is a single atomic pointer store.
+         */
+        struct TerminalModeState {
+            std::mutex mutex;
+            bool cursorHidden = false;
+            bool alternateScreen = false;
+            int guards = 0;
+            RestoreSequence sequences[2] = { { "\033[0m", 4 }, { "\033[0m", 4 } };
+            std::atomic<const RestoreSequence*> published{ &sequences[0] };
+            std::atomic<bool> rawMode{ false };
+#ifdef _WIN32
+            DWORD savedInputMode = 0;
+#else
+            struct termios savedTermios {};
+            // O_NONBLOCK lives on the open file, which the shell shares; the handler must undo it.
+            SavedDescriptorFlags savedDescriptors[4];
+#endif
+        };
+
+        inline TerminalModeState& ModeState() {
+            static TerminalModeState state;
+            return state;
+        }
+
+        /**
+         * @brief Formats the restore sequence for the current modes and publishes it. Call with the state mutex held.
+         */
+        inline void PublishRestoreSequence(TerminalModeState& State) {
+            RestoreSequence* next = (State.published.load(std::memory_order_relaxed) == &State.sequences[0])
+                ? &State.sequences[1]
+                : &State.sequences[0];
+
+            // Colors are always reset: Error() and Warning() leave theirs active on purpose.
+            std::string_view parts[3] = { "\033[0m",
+                State.cursorHidden ? "\033[?25h" : "",
+                State.alternateScreen ? "\033[?1049l" : "" };
+            next->Size = 0;
+            for (std::string_view part : parts) {
+                std::memcpy(next->Bytes + next->Size, part.data(), part.size());
+                next->Size += part.size();
+            }
+            State.published.store(next, std::memory_order_release);
+        }
+
+        /**
+         * @brief Writes the published restore sequence to standard output and leaves raw mode.
+         * Only uses async-signal-safe calls.
+         */
+        inline void WriteRestoreSequence() {
+            TerminalModeState& state = ModeState();
+#ifndef _WIN32
+            for (const SavedDescriptorFlags& saved : state.savedDescriptors) {
+                int descriptor = saved.Descriptor.load(std::memory_order_acquire);
+                if (descriptor >= 0) {
+                    fcntl(descriptor, F_SETFL, saved.Flags.load(std::memory_order_relaxed));
+                }
+            }
+            int waits = 0;
+#endif
+            const RestoreSequence* sequence = state.published.load(std::memory_order_acquire);
+            std::size_t offset = 0;
+            while (offset < sequence->Size) {
+#ifdef _WIN32
+                int written = _write(1, sequence->Bytes + offset, static_cast<unsigned int>(sequence->Size - offset));
+#else
+                ssize_t written = write(STDOUT_FILENO, sequence->Bytes + offset, sequence->Size - offset);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && waits < 10) {
+                    // Still non-blocking (another process may have set it): give the terminal up to a second.
+                    struct pollfd output = { STDOUT_FILENO, POLLOUT, 0 };
+                    poll(&output, 1, 100);
+                    waits++;
+                    continue;
+                }
+#endif
+                if (written <= 0) {
+                    break;
+                }
+                offset += static_cast<std::size_t>(written);
+            }
+
+            if (state.rawMode.load(std::memory_order_acquire)) {
+#ifdef _WIN32
+                SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), state.savedInputMode);
+#else
+                tcsetattr(STDIN_FILENO, TCSANOW, &state.savedTermios);
+#endif
+            }
+        }
+
+#ifdef _WIN32
+        inline BOOL WINAPI OnConsoleControl(DWORD) {
+            WriteRestoreSequence();
+            return FALSE; // let the default handler end the process
+        }
+
+        inline void (*PreviousSignalHandlers[2])(int) = { nullptr, nullptr };
+        inline constexpr int TerminatingSignals[2] = { SIGSEGV, SIGABRT };
+
+        inline void OnTerminatingSignal(int Signal) {
+            WriteRestoreSequence();
+            std::signal(Signal, SIG_DFL);
+            std::raise(Signal);
+        }
+#else
+        inline constexpr int TerminatingSignals[] = { SIGINT, SIGTERM, SIGHUP, SIGQUIT, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+        inline constexpr std::size_t TerminatingSignalCount = sizeof(TerminatingSignals) / sizeof(TerminatingSignals[0]);
+        inline struct sigaction PreviousSignalActions[TerminatingSignalCount] = {};
+        inline bool SignalInstalled[TerminatingSignalCount] = {};
+
+        /**
+         * @brief Whether Signal reports a fault or an abort, after which the process cannot carry on.
+         */
+        inline bool IsFaultSignal(int Signal) {
+            return Signal == SIGSEGV || Signal == SIGBUS || Signal == SIGFPE || Signal == SIGILL || Signal == SIGABRT;
+        }
+
+        inline void OnTerminatingSignal(int Signal, siginfo_t* Info, void* Context) {
+            int savedErrno = errno;
+
+            for (std::size_t i = 0; i < TerminatingSignalCount; i++) {
+                if (TerminatingSignals[i] != Signal) {
+                    continue;
+                }
+                const struct sigaction& previous = PreviousSignalActions[i];
+                bool chained = (previous.sa_flags & SA_SIGINFO)
+                    || (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN);
+                if (!chained) {
+                    break;
+                }
+
+                // A handler for SIGINT and the like may cancel some work and return, with the program
+                // still drawing on the terminal, so its modes are left alone. If the handler ends the
+                // program through exit() or by leaving the guard's scope, the terminal is restored then.
+                if (IsFaultSignal(Signal)) {
+                    WriteRestoreSequence();
+                }
+                errno = savedErrno;
+                if (previous.sa_flags & SA_SIGINFO) {
+                    previous.sa_sigaction(Signal, Info, Context);
+                }
+                else {
+                    previous.sa_handler(Signal);
+                }
+                return;
+            }
+
+            // Default action: terminate (and dump core) exactly as if we had never been here.
+            // The signal is blocked inside the handler, so it is delivered again once we return.
+            WriteRestoreSequence();
+            signal(Signal, SIG_DFL);
+            raise(Signal);
+            errno = savedErrno;
+        }
+#endif
+
+        inline void InstallRestoreHandlers() {
+#ifdef _WIN32
+            SetConsoleCtrlHandler(OnConsoleControl, TRUE);
+            for (int i = 0; i < 2; i++) {
+                PreviousSignalHandlers[i] = std::signal(TerminatingSignals[i], OnTerminatingSignal);
+            }
+#else
+            for (std::size_t i = 0; i < TerminatingSignalCount; i++) {
+                struct sigaction current {};
+                sigaction(TerminatingSignals[i], nullptr, &current);
+                if (!(current.sa_flags & SA_SIGINFO) && current.sa_handler == SIG_IGN) {
+                    continue; // ignored signals (SIGHUP under nohup) stay ignored
+                }
+                struct sigaction action {};
+                action.sa_sigaction = OnTerminatingSignal;
+                sigemptyset(&action.sa_mask);
+                action.sa_flags = SA_SIGINFO | SA_RESTART;
+                sigaction(TerminatingSignals[i], &action, &PreviousSignalActions[i]);
+                SignalInstalled[i] = true;
+            }
+#endif
+        }
+
+        inline void RemoveRestoreHandlers() {
+#ifdef _WIN32
+            SetConsoleCtrlHandler(OnConsoleControl, FALSE);
+            for (int i = 0; i < 2; i++) {
+                std::signal(TerminatingSignals[i], PreviousSignalHandlers[i] != nullptr ? PreviousSignalHandlers[i] : SIG_DFL);
+            }
+#else
+            for (std::size_t i = 0; i < TerminatingSignalCount; i++) {
+                if (SignalInstalled[i]) {
+                    sigaction(TerminatingSignals[i], &PreviousSignalActions[i], nullptr);
+                    SignalInstalled[i] = false;
+                }
+            }
+#endif
+        }
+    } // namespace detail
+
+    /**
+     * @brief Installs the restoring signal handlers when the first guard is created. Also covers
+     * exit() calls, which skip the guard's destructor.
+     */
+    CONSOLETOOLS_INLINE TerminalStateGuard::TerminalStateGuard() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.guards++ == 0) {
+            detail::PublishRestoreSequence(state);
+            detail::InstallRestoreHandlers();
+
+            static bool atExitRegistered = false;
+            if (!atExitRegistered) {
+                atExitRegistered = true;
+                std::atexit([]() {
+                    if (detail::ModeState().guards > 0) {
+                        detail::WriteRestoreSequence();
+                    }
+                });
+            }
+        }
+    }
+
+    /**
+     * @brief Restores the terminal and, when the last guard goes away, removes the signal handlers.
+     */
+    CONSOLETOOLS_INLINE TerminalStateGuard::~TerminalStateGuard() {
+        RestoreTerminalState();
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (--state.guards == 0) {
+            detail::RemoveRestoreHandlers();
+        }
+    }
+
+    /**
+     * @brief Hides the cursor and remembers to show it again on restore.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void HideCursor() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.cursorHidden = true;
+        detail::PublishRestoreSequence(state);
+        Print("\033[?25l");
+    }
+
+    /**
+     * @brief Shows the cursor again.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void ShowCursor() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.cursorHidden = false;
+        detail::PublishRestoreSequence(state);
+        Print("\033[?25h");
+    }
+
+    /**
+     * @brief Switches to the alternate screen buffer (full-screen mode) and remembers to leave it on restore.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void EnterAlternateScreen() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.alternateScreen = true;
+        detail::PublishRestoreSequence(state);
+        Print("\033[?1049h");
+    }
+
+    /**
+     * @brief Returns to the normal screen buffer.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void LeaveAlternateScreen() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.alternateScreen = false;
+        detail::PublishRestoreSequence(state);
+        Print("\033[?1049l");
+    }
+
+    /**
+     * @brief Turns off line buffering and echo on standard input, so key presses arrive immediately.
+     * Ctrl+C still raises SIGINT.
+     * @return true if standard input is a terminal and its mode was changed.
+     */
+    CONSOLETOOLS_INLINE bool EnableRawMode() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.rawMode.load(std::memory_order_relaxed)) {
+            return true;
+        }
+#ifdef _WIN32
+        HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+        if (!GetConsoleMode(input, &state.savedInputMode)) {
+            return false;
+        }
+        if (!SetConsoleMode(input, state.savedInputMode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT))) {
+            return false;
+        }
+#else
+        if (tcgetattr(STDIN_FILENO, &state.savedTermios) != 0) {
+            return false;
+        }
+        struct termios raw = state.savedTermios;
+        raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0) {
+            return false;
+        }
+#endif
+        state.rawMode.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Restores the input mode saved by EnableRawMode().
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void DisableRawMode() {
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.rawMode.load(std::memory_order_relaxed)) {
+            return;
+        }
+#ifdef _WIN32
+        SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), state.savedInputMode);
+#else
+        tcsetattr(STDIN_FILENO, TCSANOW, &state.savedTermios);
+#endif
+        state.rawMode.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Resets colors and undoes every mode changed through ConsoleTools, from normal (non-signal) code.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void RestoreTerminalState() {
+        DisableRawMode();
+
+        detail::TerminalModeState& state = detail::ModeState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const detail::RestoreSequence* sequence = state.published.load(std::memory_order_relaxed);
+        Print(std::string_view(sequence->Bytes, sequence->Size));
+        FlushOutput();
+        state.cursorHidden = false;
+        state.alternateScreen = false;
+        detail::PublishRestoreSequence(state);
+    }
+
+    CONSOLETOOLS_INLINE Clock::TimePoint SystemClock::Now() const {
+        return std::chrono::steady_clock::now();
+    }
+
+    CONSOLETOOLS_INLINE void SystemClock::SleepUntil(TimePoint Deadline) {
+        std::this_thread::sleep_until(Deadline);
+    }
+
+    CONSOLETOOLS_INLINE void SystemClock::WaitUntil(std::condition_variable_any& Condition,
+        std::unique_lock<std::mutex>& Lock, TimePoint Deadline)
+    {
+        Condition.wait_until(Lock, Deadline);
+    }
+
+    /**
+     * @brief Creates a virtual clock that reads Start until it is advanced.
+     * @param Start The initial time.
+     */
+    CONSOLETOOLS_INLINE VirtualClock::VirtualClock(TimePoint Start)
+        : ticks(Start.time_since_epoch().count())
+    {
+    }
+
+    CONSOLETOOLS_INLINE Clock::TimePoint VirtualClock::Now() const {
+        return TimePoint(Duration(ticks.load(std::memory_order_acquire)));
+    }
+
+    /**
+     * @brief Moves the clock forward to Deadline (never backwards) and returns immediately.
+     */
+    CONSOLETOOLS_INLINE void VirtualClock::SleepUntil(TimePoint Deadline) {
+        Duration::rep target = Deadline.time_since_epoch().count();
+        Duration::rep current = ticks.load(std::memory_order_relaxed);
+        while (current < target && !ticks.compare_exchange_weak(current, target, std::memory_order_acq_rel)) {
+        }
+    }
+
+    /**
+     * @brief Same as SleepUntil(): the wait times out at once, with the clock already at Deadline.
+     */
+    CONSOLETOOLS_INLINE void VirtualClock::WaitUntil(std::condition_variable_any&, std::unique_lock<std::mutex>&,
+        TimePoint Deadline)
+    {
+        SleepUntil(Deadline);
+    }
+
+    /**
+     * @brief Following does not move virtual time: this returns once another thread has advanced the clock
+     * to Deadline, or on a notification. Background timers (SpinnerGroup) therefore follow the clock
+     * instead of racing ahead of it.
+     */
+    CONSOLETOOLS_INLINE void VirtualClock::FollowUntil(std::condition_variable_any& Condition,
+        std::unique_lock<std::mutex>& Lock, TimePoint Deadline)
+    {
+        if (Now() < Deadline) {
+            // Advance() does not know the waiter's condition variable, so poll in short real-time slices.
+            Condition.wait_for(Lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    /**
+     * @brief Moves the clock forward by Time.
+     * @param Time How far to advance; negative values are ignored.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void VirtualClock::Advance(Duration Time) {
+        if (Time.count() > 0) {
+            ticks.fetch_add(Time.count(), std::memory_order_acq_rel);
+        }
+    }
+
+    namespace detail {
+        inline std::atomic<Clock*> CurrentClock{ nullptr };
+    } // namespace detail
+
+    /**
+     * @brief Returns the clock that animations and captures read.
+     * @return The clock installed with SetClock(), or a SystemClock.
+     */
+    CONSOLETOOLS_INLINE Clock& GetClock() {
+        static SystemClock systemClock;
+        Clock* clock = detail::CurrentClock.load(std::memory_order_acquire);
+        return (clock != nullptr) ? *clock : systemClock;
+    }
+
+    /**
+     * @brief Replaces the clock used by spinners, the typing effect and CaptureSink timestamps.
+     * @param NewClock The new clock (for example a VirtualClock in tests), or nullptr for the system clock.
+     * The clock must outlive its use.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SetClock(Clock* NewClock) {
+        detail::CurrentClock.store(NewClock, std::memory_order_release);
+    }
+
+    /**
+     * @brief Seeds the delays of PrintTypingTextEffect so the same text always types out with the same timing.
+     * @param Seed The seed to use.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SeedTypingEffect(std::uint32_t Seed) {
+        detail::TypingGenerator().seed(Seed);
+    }
+
+    /**
+     * @brief Creates a sink that forwards output to a stream.
+     * @param Stream The stream to write to.
+     */
+    CONSOLETOOLS_INLINE StreamOutputSink::StreamOutputSink(std::ostream& Stream)
+        : stream(&Stream)
+    {
+    }
+
+    CONSOLETOOLS_INLINE void StreamOutputSink::Write(std::string_view Bytes) {
+        stream->write(Bytes.data(), static_cast<std::streamsize>(Bytes.size()));
+    }
+
+    CONSOLETOOLS_INLINE void StreamOutputSink::Flush() {
+        stream->flush();
+    }
+
+    namespace detail {
+        /**
+         * @brief Writes Parts to Descriptor in order, retrying partial writes and EINTR.
+         * @param Calls Incremented once per system call made.
+         * @param Wait Wait for a non-blocking descriptor to become writable instead of stopping at EAGAIN.
+         * @param WouldBlock Set when the descriptor refused more output (only when Wait is false).
+         * @return Bytes consumed. Output the descriptor reported an error for counts as consumed and is dropped.
+         */
+        inline std::size_t WriteParts(int Descriptor, const std::string_view* Parts, std::size_t Count,
+            std::atomic<std::uint64_t>& Calls, bool Wait, bool& WouldBlock)
+        {
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < Count; i++) {
+                total += Parts[i].size();
+            }
+#ifdef _WIN32
+            static_cast<void>(Wait);
+            static_cast<void>(WouldBlock);
+            for (std::size_t i = 0; i < Count; i++) {
+                std::string_view part = Parts[i];
+                while (!part.empty()) {
+                    unsigned int chunk = static_cast<unsigned int>(std::min<std::size_t>(part.size(), 1u << 30));
+                    int written = _write(Descriptor, part.data(), chunk);
+                    Calls.fetch_add(1, std::memory_order_relaxed);
+                    if (written < 0) {
+                        return total;
+                    }
+                    part.remove_prefix(static_cast<std::size_t>(written));
+                }
+            }
+            return total;
+#else
+            constexpr std::size_t MaxVectors = 64;
+            struct iovec vectors[MaxVectors];
+            std::size_t next = 0;   // first part not yet fully written
+            std::size_t offset = 0; // bytes of Parts[next] already written
+            std::size_t done = 0;
+
+            while (next < Count) {
+                std::size_t vectorCount = 0;
+                std::size_t skip = offset;
+                for (std::size_t i = next; i < Count && vectorCount < MaxVectors; i++) {
+                    if (Parts[i].size() > skip) {
+                        vectors[vectorCount].iov_base = const_cast<char*>(Parts[i].data() + skip);
+                        vectors[vectorCount].iov_len = Parts[i].size() - skip;
+                        vectorCount++;
+                    }
+                    skip = 0;
+                }
+                if (vectorCount == 0) {
+                    return total;
+                }
+
+                ssize_t written = ::writev(Descriptor, vectors, static_cast<int>(vectorCount));
+                Calls.fetch_add(1, std::memory_order_relaxed);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        if (!Wait) {
+                            WouldBlock = true;
+                            return done;
+                        }
+                        struct pollfd writable = { Descriptor, POLLOUT, 0 };
+                        ::poll(&writable, 1, -1);
+                        continue;
+                    }
+                    return total;
+                }
+
+                std::size_t remaining = static_cast<std::size_t>(written);
+                done += remaining;
+                while (next < Count) {
+                    std::size_t left = Parts[next].size() - offset;
+                    if (remaining < left) {
+                        offset += remaining;
+                        break;
+                    }
+                    remaining -= left;
+                    next++;
+                    offset = 0;
+                }
+            }
+            return total;
+#endif
+        }
+    } // namespace detail
+
+    /**
+     * @brief Creates a buffered sink for an already open file descriptor. The descriptor is not closed.
+     * @param Descriptor The descriptor to write to (1 for standard output).
+     * @param BufferSize Bytes collected before a write is forced.
+     */
+    CONSOLETOOLS_INLINE FileDescriptorSink::FileDescriptorSink(int Descriptor, std::size_t BufferSize)
+        : descriptor(Descriptor),
+        buffer(new char[BufferSize > 0 ? BufferSize : 1]),
+        capacity(BufferSize > 0 ? BufferSize : 1)
+    {
+    }
+
+    /**
+     * @brief Writes whatever is still buffered, waiting for the descriptor if necessary, and puts
+     * the descriptor back into blocking mode if SetNonBlocking() changed it.
+     */
+    CONSOLETOOLS_INLINE FileDescriptorSink::~FileDescriptorSink() {
+        SetNonBlocking(false);
+        Drain();
+    }
+
+    CONSOLETOOLS_INLINE void FileDescriptorSink::Write(std::string_view Bytes) {
+        WriteGather(&Bytes, 1);
+    }
+
+    /**
+     * @brief Buffers Parts, or writes the buffer and Parts together with one gather write if they do not fit.
+     */
+    CONSOLETOOLS_INLINE void FileDescriptorSink::WriteGather(const std::string_view* Parts, std::size_t Count) {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < Count; i++) {
+            total += Parts[i].size();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (used + total <= capacity) {
+            for (std::size_t i = 0; i < Count; i++) {
+                if (!Parts[i].empty()) {
+                    std::memcpy(buffer.get() + used, Parts[i].data(), Parts[i].size());
+                    used += Parts[i].size();
+                }
+            }
+            return;
+        }
+        WriteLocked(Parts, Count, !nonBlocking);
+    }
+
+    /**
+     * @brief Writes the buffered bytes to the descriptor. In non-blocking mode, only as many as it accepts right now.
+     */
+    CONSOLETOOLS_INLINE void FileDescriptorSink::Flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (used == 0 && backlog.empty()) {
+            return;
+        }
+        WriteLocked(nullptr, 0, !nonBlocking);
+    }
+
+    /**
+     * @brief Writes the backlog, the buffer and Parts, in that order, with one gather write.
+     * Anything the descriptor does not accept becomes the new backlog.
+     * @param Wait Block until everything is written.
+     */
+    CONSOLETOOLS_INLINE void FileDescriptorSink::WriteLocked(const std::string_view* Parts, std::size_t Count, bool Wait) {
+        constexpr std::size_t FixedParts = 8;
+        std::string_view fixed[FixedParts];
+        std::vector<std::string_view> many;
+        std::string_view* all = fixed;
+        if (Count + 2 > FixedParts) {
+            many.resize(Count + 2);
+            all = many.data();
+        }
+
+        std::size_t partCount = 0;
+        std::size_t total = 0;
+        if (!backlog.empty()) {
+            all[partCount++] = backlog;
+        }
+        if (used > 0) {
+            all[partCount++] = std::string_view(buffer.get(), used);
+        }
+        for (std::size_t i = 0; i < Count; i++) {
+            if (!Parts[i].empty()) {
+                all[partCount++] = Parts[i];
+            }
+        }
+        for (std::size_t i = 0; i < partCount; i++) {
+            total += all[i].size();
+        }
+
+        bool blocked = false;
+        std::size_t written = detail::WriteParts(descriptor, all, partCount, systemCalls, Wait, blocked);
+        if (blocked) {
+            wouldBlock.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (written >= total) {
+            backlog.clear();
+        }
+        else {
+            // The backlog (if any) is the first part: trim it in place and append the unwritten rest.
+            std::size_t skip = written;
+            std::size_t first = 0;
+            if (!backlog.empty()) {
+                std::size_t trimmed = std::min(skip, backlog.size());
+                backlog.erase(0, trimmed);
+                skip -= trimmed;
+                first = 1;
+            }
+            for (std::size_t i = first; i < partCount; i++) {
+                if (all[i].size() <= skip) {
+                    skip -= all[i].size();
+                    continue;
+                }
+                backlog.append(all[i].substr(skip));
+                skip = 0;
+            }
+        }
+        used = 0;
+
+        if (backlog.size() > MaxBacklog) {
+            std::string_view rest = backlog;
+            detail::WriteParts(descriptor, &rest, 1, systemCalls, true, blocked);
+            backlog.clear();
+        }
+        pendingBytes.store(backlog.size(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Switches the descriptor to non-blocking writes (O_NONBLOCK) or back.
+     * The flag belongs to the open file, so it also affects other writers of the same descriptor
+     * (std::cout and printf when this is standard output); send output through Print() while it is set.
+     * Switching back first writes out the backlog. The original flags are recorded for
+     * TerminalStateGuard, whose handler puts them back if the program dies while the flag is set.
+     * @param NonBlocking true for non-blocking writes.
+     * @return false if the mode could not be changed (always, for NonBlocking on Windows), or if
+     * four sinks are non-blocking already.
+     */
+    CONSOLETOOLS_INLINE bool FileDescriptorSink::SetNonBlocking(bool NonBlocking) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (NonBlocking == nonBlocking) {
+            return true;
+        }
+#ifdef _WIN32
+        return false;
+#else
+        if (NonBlocking) {
+            int flags = ::fcntl(descriptor, F_GETFL);
+            if (flags < 0) {
+                return false;
+            }
+            // Record the flags where the signal handler can restore them before changing anything.
+            // The state mutex is not taken: it is held while printing, which takes ours.
+            for (detail::SavedDescriptorFlags& saved : detail::ModeState().savedDescriptors) {
+                int unused = -1;
+                if (saved.Descriptor.compare_exchange_strong(unused, -2, std::memory_order_acquire)) {
+                    saved.Flags.store(flags, std::memory_order_relaxed);
+                    saved.Descriptor.store(descriptor, std::memory_order_release);
+                    savedFlags = &saved;
+                    break;
+                }
+            }
+            if (savedFlags == nullptr) {
+                return false;
+            }
+            if (::fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) < 0) {
+                savedFlags->Descriptor.store(-1, std::memory_order_release);
+                savedFlags = nullptr;
+                return false;
+            }
+            originalFlags = flags;
+            nonBlocking = true;
+            return true;
+        }
+
+        WriteLocked(nullptr, 0, true);
+        if (::fcntl(descriptor, F_SETFL, originalFlags) < 0) {
+            return false;
+        }
+        savedFlags->Descriptor.store(-1, std::memory_order_release);
+        savedFlags = nullptr;
+        nonBlocking = false;
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Writes the buffer and the backlog, waiting for the descriptor as long as necessary.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FileDescriptorSink::Drain() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (used == 0 && backlog.empty()) {
+            return;
+        }
+        WriteLocked(nullptr, 0, true);
+    }
+
+    /**
+     * @brief Returns how many bytes the kernel still holds in the descriptor's output queue
+     * (written, but not yet sent to the terminal or peer).
+     * @return The queue length, or -1 where the platform or descriptor type cannot tell.
+     */
+    CONSOLETOOLS_INLINE long FileDescriptorSink::QueuedBytes() const {
+#if !defined(_WIN32) && defined(TIOCOUTQ)
+        int queued = 0;
+        if (::ioctl(descriptor, TIOCOUTQ, &queued) == 0) {
+            return queued;
+        }
+#endif
+        return -1;
+    }
+
+    namespace detail {
+        inline std::atomic<OutputSink*> CurrentSink{ nullptr };
+        inline std::atomic<int> CurrentBackend{ static_cast<int>(OutputBackend::Stream) };
+
+        inline OutputSink& DefaultSink(OutputBackend Backend) {
+            if (Backend == OutputBackend::FileDescriptor) {
+                static FileDescriptorSink descriptorSink(1);
+                return descriptorSink;
+            }
+            static StreamOutputSink streamSink(std::cout);
+            return streamSink;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Returns the sink that ConsoleTools currently prints to.
+     * @return The sink installed with SetOutputSink(), or the default sink of the selected OutputBackend.
+     */
+    CONSOLETOOLS_INLINE OutputSink& GetOutputSink() {
+        OutputSink* sink = detail::CurrentSink.load(std::memory_order_acquire);
+        if (sink != nullptr) {
+            return *sink;
+        }
+        return detail::DefaultSink(static_cast<OutputBackend>(detail::CurrentBackend.load(std::memory_order_relaxed)));
+    }
+
+    /**
+     * @brief Returns the backend used while no sink is installed.
+     */
+    CONSOLETOOLS_INLINE OutputBackend GetOutputBackend() {
+        return static_cast<OutputBackend>(detail::CurrentBackend.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Selects how output is written while no sink is installed: through std::cout (the default)
+     * or directly to file descriptor 1. Pending output of the previous backend is flushed first.
+     * @param Backend The backend to use from now on.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SetOutputBackend(OutputBackend Backend) {
+        OutputBackend previous = static_cast<OutputBackend>(
+            detail::CurrentBackend.exchange(static_cast<int>(Backend), std::memory_order_relaxed));
+        if (previous != Backend) {
+            detail::DefaultSink(previous).Flush();
+        }
+    }
+
+    /**
+     * @brief Redirects everything ConsoleTools prints to another sink (for example a CaptureSink in tests).
+     * @param Sink The new sink, or nullptr to go back to std::cout. The sink must outlive its use.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SetOutputSink(OutputSink* Sink) {
+        detail::CurrentSink.store(Sink, std::memory_order_release);
+    }
+
+    /**
+     * @brief Writes text to the current output sink without flushing.
+     * @param Text The text to print.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Print(std::string_view Text) {
+        CONSOLETOOLS_MEASURE(Metric::Print);
+        CONSOLETOOLS_MEASURE_BYTES(Text.size());
+        GetOutputSink().Write(Text);
+    }
+
+    /**
+     * @brief Writes several pieces to the current output sink as one gather write, without flushing.
+     * @param Parts The pieces, in order.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Print(std::initializer_list<std::string_view> Parts) {
+        CONSOLETOOLS_MEASURE(Metric::Print);
+#if CONSOLETOOLS_ENABLE_INSTRUMENTATION
+        for (std::string_view part : Parts) {
+            CONSOLETOOLS_MEASURE_BYTES(part.size());
+        }
+#endif
+        GetOutputSink().WriteGather(Parts.begin(), Parts.size());
+    }
+
+    /**
+     * @brief Flushes the current output sink.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FlushOutput() {
+        CONSOLETOOLS_MEASURE(Metric::Flush);
+        GetOutputSink().Flush();
+    }
+
+    /**
+     * @brief Creates an empty histogram.
+     */
+    CONSOLETOOLS_INLINE LogLinearHistogram::LogLinearHistogram()
+        : buckets(static_cast<std::size_t>(BucketCount), 0)
+    {
+    }
+
+    /**
+     * @brief Records Value, Count times.
+     * @param Value The value to record.
+     * @param Count How many times it occurred.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void LogLinearHistogram::Record(std::uint64_t Value, std::uint64_t Count) {
+        if (Count == 0) {
+            return;
+        }
+        buckets[static_cast<std::size_t>(BucketIndex(Value))] += Count;
+        min = (count == 0) ? Value : std::min(min, Value);
+        max = (count == 0) ? Value : std::max(max, Value);
+        count += Count;
+        sum += static_cast<double>(Value) * static_cast<double>(Count);
+    }
+
+    /**
+     * @brief Adds Count values to one bucket when only the bucket is known, as with counters that
+     * were collected per bucket. Min, max and mean use the bucket's lower bound.
+     * @param Index The bucket index, from BucketIndex().
+     * @param Count How many values fell into the bucket.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void LogLinearHistogram::RecordBucket(int Index, std::uint64_t Count) {
+        if (Count == 0 || Index < 0 || Index >= BucketCount) {
+            return;
+        }
+        std::uint64_t value = BucketLowerBound(Index);
+        buckets[static_cast<std::size_t>(Index)] += Count;
+        min = (count == 0) ? value : std::min(min, value);
+        max = (count == 0) ? value : std::max(max, value);
+        count += Count;
+        sum += static_cast<double>(value) * static_cast<double>(Count);
+    }
+
+    /**
+     * @brief Replaces Min() and Max() with exact values, for a histogram rebuilt with RecordBucket()
+     * from counters that also tracked their extremes. Percentile() is then clamped to the exact range.
+     * Does nothing if the histogram is empty or Min is greater than Max.
+     * @param Min The smallest value recorded.
+     * @param Max The largest value recorded.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void LogLinearHistogram::SetRange(std::uint64_t Min, std::uint64_t Max) {
+        if (count == 0 || Min > Max) {
+            return;
+        }
+        min = Min;
+        max = Max;
+    }
+
+    /**
+     * @brief Adds every value recorded in Other to this histogram.
+     * @param Other The histogram to merge in.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void LogLinearHistogram::Merge(const LogLinearHistogram& Other) {
+        if (Other.count == 0) {
+            return;
+        }
+        for (std::size_t i = 0; i < buckets.size(); i++) {
+            buckets[i] += Other.buckets[i];
+        }
+        min = (count == 0) ? Other.min : std::min(min, Other.min);
+        max = (count == 0) ? Other.max : std::max(max, Other.max);
+        count += Other.count;
+        sum += Other.sum;
+    }
+
+    /**
+     * @brief Forgets every recorded value.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void LogLinearHistogram::Clear() {
+        std::fill(buckets.begin(), buckets.end(), 0);
+        count = 0;
+        min = 0;
+        max = 0;
+        sum = 0.0;
+    }
+
+    /**
+     * @brief Returns the mean of the recorded values, or 0 if there are none.
+     * @return The mean.
+     */
+    CONSOLETOOLS_INLINE double LogLinearHistogram::Mean() const {
+        return count ? sum / static_cast<double>(count) : 0.0;
+    }
+
+    /**
+     * @brief Returns a value that at least Percent percent of the recorded values do not exceed.
+     * The result is the top of the bucket the percentile falls into, clamped to [Min(), Max()].
+     * @param Percent The percentile, from 0 to 100.
+     * @return The percentile value, or 0 if nothing was recorded.
+     */
+    CONSOLETOOLS_INLINE std::uint64_t LogLinearHistogram::Percentile(double Percent) const {
+        if (count == 0) {
+            return 0;
+        }
+        Percent = std::clamp(Percent, 0.0, 100.0);
+        std::uint64_t rank = static_cast<std::uint64_t>(Percent / 100.0 * static_cast<double>(count) + 0.5);
+        rank = std::clamp<std::uint64_t>(rank, 1, count);
+
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BucketCount; i++) {
+            seen += buckets[static_cast<std::size_t>(i)];
+            if (seen >= rank) {
+                return std::clamp<std::uint64_t>(BucketUpperBound(i) - 1, min, max);
+            }
+        }
+        return max;
+    }
+
+    /**
+     * @brief Returns the display name of a metric.
+     * @param Id The metric.
+     * @return The name, for example "AdvancedProgressBar".
+     */
+    CONSOLETOOLS_INLINE std::string_view MetricName(Metric Id) {
+        switch (Id) {
+        case Metric::Spacing: return "Spacing";
+        case Metric::Header: return "Header";
+        case Metric::AdvancedHeader: return "AdvancedHeader";
+        case Metric::ProgressBar: return "ProgressBar";
+        case Metric::AdvancedProgressBar: return "AdvancedProgressBar";
+        case Metric::Error: return "Error";
+        case Metric::Warning: return "Warning";
+        case Metric::Notification: return "Notification";
+        case Metric::CachedProgressBar: return "CachedProgressBar";
+        case Metric::CachedAdvancedProgressBar: return "CachedAdvancedProgressBar";
+        case Metric::SpinnerFrame: return "SpinnerFrame";
+        case Metric::LogWrite: return "LogWrite";
+        case Metric::Print: return "Print";
+        case Metric::Flush: return "Flush";
+        default: return "Unknown";
+        }
+    }
+
+    /**
+     * @brief Sums the counters of every thread, including threads that have exited.
+     * Other threads keep recording while the snapshot is taken, so it may include part of a concurrent call.
+     * @return One entry per Metric, or an empty vector when instrumentation is compiled out.
+     */
+    CONSOLETOOLS_INLINE std::vector<MetricSnapshot> TakeInstrumentationSnapshot() {
+        std::vector<MetricSnapshot> snapshot;
+#if CONSOLETOOLS_ENABLE_INSTRUMENTATION
+        snapshot.resize(static_cast<std::size_t>(Metric::Count));
+        for (int m = 0; m < static_cast<int>(Metric::Count); m++) {
+            snapshot[static_cast<std::size_t>(m)].Id = static_cast<Metric>(m);
+            snapshot[static_cast<std::size_t>(m)].Name = MetricName(static_cast<Metric>(m));
+        }
+
+        std::uint64_t minimums[static_cast<int>(Metric::Count)];
+        std::uint64_t maximums[static_cast<int>(Metric::Count)] = {};
+        std::fill(std::begin(minimums), std::end(minimums), std::numeric_limits<std::uint64_t>::max());
+
+        auto add = [&](const detail::InstrumentationShard& Shard) {
+            for (int m = 0; m < static_cast<int>(Metric::Count); m++) {
+                const detail::MetricCounters& counters = Shard.Metrics[m];
+                MetricSnapshot& entry = snapshot[static_cast<std::size_t>(m)];
+                entry.Calls += counters.Calls.load(std::memory_order_relaxed);
+                entry.Bytes += counters.Bytes.load(std::memory_order_relaxed);
+                entry.Allocations += counters.Allocations.load(std::memory_order_relaxed);
+                for (int b = 0; b < LogLinearHistogram::BucketCount; b++) {
+                    entry.Latency.RecordBucket(b, counters.Latency[b].load(std::memory_order_relaxed));
+                }
+                minimums[m] = std::min(minimums[m], counters.MinLatency.load(std::memory_order_relaxed));
+                maximums[m] = std::max(maximums[m], counters.MaxLatency.load(std::memory_order_relaxed));
+            }
+        };
+
+        detail::InstrumentationRegistry& registry = detail::Registry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        add(registry.Retired);
+        for (const detail::InstrumentationShard* shard : registry.Shards) {
+            add(*shard);
+        }
+        for (int m = 0; m < static_cast<int>(Metric::Count); m++) {
+            snapshot[static_cast<std::size_t>(m)].Latency.SetRange(minimums[m], maximums[m]);
+        }
+#endif
+        return snapshot;
+    }
+
+    /**
+     * @brief Formats a snapshot as a plain-text table, one row per metric that was called.
+     * "max ns" is the exact slowest call. The percentiles are the top of the histogram bucket they fall
+     * into (within about 6% above the true value), never more than the maximum.
+     * @return The table, or a note on how to enable instrumentation when it is compiled out.
+     */
+    CONSOLETOOLS_INLINE std::string DumpInstrumentation() {
+        if (!INSTRUMENTATION_ENABLED) {
+            return "Instrumentation is disabled (build with CONSOLETOOLS_ENABLE_INSTRUMENTATION=1).\n";
+        }
+
+        std::string table;
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-26s %12s %14s %10s %10s %10s %10s\n",
+            "Metric", "Calls", "Bytes", "Allocs", "p50 ns", "p99 ns", "max ns");
+        table.append(line);
+        for (const MetricSnapshot& entry : TakeInstrumentationSnapshot()) {
+            if (entry.Calls == 0) {
+                continue;
+            }
+            std::snprintf(line, sizeof(line), "%-26.*s %12llu %14llu %10llu %10llu %10llu %10llu\n",
+                static_cast<int>(entry.Name.size()), entry.Name.data(),
+                static_cast<unsigned long long>(entry.Calls),
+                static_cast<unsigned long long>(entry.Bytes),
+                static_cast<unsigned long long>(entry.Allocations),
+                static_cast<unsigned long long>(entry.Latency.Percentile(50.0)),
+                static_cast<unsigned long long>(entry.Latency.Percentile(99.0)),
+                static_cast<unsigned long long>(entry.Latency.Max()));
+            table.append(line);
+        }
+        return table;
+    }
+
+    /**
+     * @brief Zeroes every counter. Calls running on other threads at the same time may be partly kept.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void ResetInstrumentation() {
+#if CONSOLETOOLS_ENABLE_INSTRUMENTATION
+        auto clear = [](detail::InstrumentationShard& Shard) {
+            for (detail::MetricCounters& counters : Shard.Metrics) {
+                counters.Calls.store(0, std::memory_order_relaxed);
+                counters.Bytes.store(0, std::memory_order_relaxed);
+                counters.Allocations.store(0, std::memory_order_relaxed);
+                for (std::atomic<std::uint64_t>& bucket : counters.Latency) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                counters.MinLatency.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+                counters.MaxLatency.store(0, std::memory_order_relaxed);
+            }
+        };
+
+        detail::InstrumentationRegistry& registry = detail::Registry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        clear(registry.Retired);
+        for (detail::InstrumentationShard* shard : registry.Shards) {
+            clear(*shard);
+        }
+#endif
+    }
+
+    /**
+     * @brief Creates a monitor that allows one frame per MinInterval until the output falls behind.
+     * @param MinInterval Shortest time between frames (the frame rate when the terminal keeps up).
+     * @param MaxInterval Longest time between frames, however slow the terminal is.
+     */
+    CONSOLETOOLS_INLINE FrameMonitor::FrameMonitor(std::chrono::milliseconds MinInterval, std::chrono::milliseconds MaxInterval)
+        : minInterval(std::max(MinInterval, std::chrono::milliseconds(0))),
+        maxInterval(std::max(MaxInterval, MinInterval)),
+        interval(std::chrono::duration_cast<Clock::Duration>(minInterval).count())
+    {
+    }
+
+    /**
+     * @brief Decides whether to draw a frame now. Counts the frame as drawn or dropped.
+     * A frame is dropped when it comes less than the current interval (give or take half a
+     * MinInterval) after the previous one, or while the sink still has PendingBytes.
+     * @param Now The current time of the clock driving the frames.
+     * @param PendingBytes The sink's PendingBytes().
+     * @return true to draw, false to skip this frame.
+     */
+    CONSOLETOOLS_INLINE bool FrameMonitor::ShouldDraw(Clock::TimePoint Now, std::size_t PendingBytes) {
+        Clock::Duration current(interval.load(std::memory_order_relaxed));
+        if (PendingBytes > 0 || (hasDrawn && Now - lastDraw + minInterval / 2 < current)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        lastDraw = Now;
+        hasDrawn = true;
+        drawn.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Reports how long writing a drawn frame took, and adapts the interval to it.
+     * @param Start When the write started.
+     * @param End When the write (including the flush) returned.
+     * @param PendingBytes The sink's PendingBytes() after the write.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FrameMonitor::FrameWritten(Clock::TimePoint Start, Clock::TimePoint End, std::size_t PendingBytes) {
+        Clock::Duration took = std::max(End - Start, Clock::Duration::zero());
+        {
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latency.Record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(took).count()));
+        }
+
+        Clock::Duration current(interval.load(std::memory_order_relaxed));
+        Clock::Duration next = current;
+        if (PendingBytes > 0) {
+            backlogged.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (PendingBytes > 0 || took * 4 > current) {
+            next = std::min<Clock::Duration>(std::max<Clock::Duration>(current * 2, std::chrono::milliseconds(1)), maxInterval);
+        }
+        else if (took * 16 < current) {
+            next = std::max<Clock::Duration>(current - current / 8, minInterval);
+        }
+        interval.store(next.count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns to MinInterval and clears the counters and the latency histogram.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FrameMonitor::Reset() {
+        interval.store(std::chrono::duration_cast<Clock::Duration>(minInterval).count(), std::memory_order_relaxed);
+        hasDrawn = false;
+        drawn.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        backlogged.store(0, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        latency.Clear();
+    }
+
+    /**
+     * @brief Returns a copy of the write latencies reported so far, in nanoseconds.
+     */
+    CONSOLETOOLS_INLINE LogLinearHistogram FrameMonitor::WriteLatency() const {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        return latency;
+    }
+
+    /**
+     * @brief Creates an empty capture whose timestamps are relative to now.
+     */
+    CONSOLETOOLS_INLINE CaptureSink::CaptureSink()
+        : start(GetClock().Now())
+    {
+    }
+
+    /**
+     * @brief Records a chunk of output and the time it was written.
+     * @param Bytes The bytes that would have been printed.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void CaptureSink::Write(std::string_view Bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        writes.push_back(Chunk{ GetClock().Now() - start, bytes.size(), Bytes.size() });
+        bytes.append(Bytes);
+    }
+
+    /**
+     * @brief Closes the current frame. Flushes with no new bytes since the last frame are ignored.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void CaptureSink::Flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes.size() == frameStart) {
+            return;
+        }
+        frames.push_back(Chunk{ GetClock().Now() - start, frameStart, bytes.size() - frameStart });
+        frameStart = bytes.size();
+    }
+
+    /**
+     * @brief Discards everything captured so far and restarts the clock.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void CaptureSink::Clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        start = GetClock().Now();
+        bytes.clear();
+        writes.clear();
+        frames.clear();
+        frameStart = 0;
+    }
+
+    /**
+     * @brief Returns every byte written so far.
+     * @return A copy of the captured output.
+     */
+    CONSOLETOOLS_INLINE std::string CaptureSink::Bytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return bytes;
+    }
+
+    /**
+     * @brief Returns one chunk per Write() call.
+     * @return A copy of the recorded writes.
+     */
+    CONSOLETOOLS_INLINE std::vector<CaptureSink::Chunk> CaptureSink::Writes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return writes;
+    }
+
+    /**
+     * @brief Returns one chunk per frame, i.e. per Flush() that followed new output.
+     * @return A copy of the recorded frames.
+     */
+    CONSOLETOOLS_INLINE std::vector<CaptureSink::Chunk> CaptureSink::Frames() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frames;
+    }
+
+    /**
+     * @brief Returns the average number of bytes per frame.
+     * @return Bytes per frame, or 0 if no frame was recorded.
+     */
+    CONSOLETOOLS_INLINE double CaptureSink::BytesPerFrame() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frames.empty()) {
+            return 0.0;
+        }
+        return static_cast<double>(frames.back().Offset + frames.back().Size) / frames.size();
+    }
+
+    /**
+     * @brief Returns the frame rate between the first and the last frame.
+     * @return Frames per second, or 0 if fewer than two frames were recorded.
+     */
+    CONSOLETOOLS_INLINE double CaptureSink::FramesPerSecond() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frames.size() < 2) {
+            return 0.0;
+        }
+        double seconds = std::chrono::duration<double>(frames.back().Time - frames.front().Time).count();
+        return (seconds > 0.0) ? (frames.size() - 1) / seconds : 0.0;
+    }
+
+    CONSOLETOOLS_INLINE bool VirtualTerminal::Cell::operator==(const Cell& Other) const {
+        return Glyph == Other.Glyph
+            && Foreground == Other.Foreground
+            && Background == Other.Background
+            && Bold == Other.Bold
+            && Underline == Other.Underline
+            && Inverse == Other.Inverse;
+    }
+
+    /**
+     * @brief Creates a blank terminal with the cursor in the top-left corner.
+     * @param Columns Width of the screen in cells.
+     * @param Rows Height of the screen in cells.
+     */
+    CONSOLETOOLS_INLINE VirtualTerminal::VirtualTerminal(int Columns, int Rows)
+        : columns(std::max(Columns, 1)),
+        rows(std::max(Rows, 1)),
+        cells(static_cast<std::size_t>(columns) * rows)
+    {
+    }
+
+    /**
+     * @brief Clears the screen, the pen and the cursor state.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void VirtualTerminal::Reset() {
+        std::fill(cells.begin(), cells.end(), Cell());
+        pen = Cell();
+        cursorRow = cursorColumn = 0;
+        wrapPending = false;
+        cursorVisible = true;
+        scrolledLines = 0;
+        pending.clear();
+    }
+
+    CONSOLETOOLS_INLINE VirtualTerminal::Cell& VirtualTerminal::CellAt(int Row, int Column) {
+        return cells[static_cast<std::size_t>(Row) * columns + Column];
+    }
+
+    /**
+     * @brief Returns the cell at a position. Out-of-range positions return a blank cell.
+     * @param Row Zero-based row.
+     * @param Column Zero-based column.
+     * @return The cell contents and style.
+     */
+    CONSOLETOOLS_INLINE const VirtualTerminal::Cell& VirtualTerminal::At(int Row, int Column) const {
+        static const Cell blank;
+        if (Row < 0 || Row >= rows || Column < 0 || Column >= columns) {
+            return blank;
+        }
+        return cells[static_cast<std::size_t>(Row) * columns + Column];
+    }
+
+    /**
+     * @brief Returns the text of one row without styling or trailing spaces.
+     * @param Row Zero-based row.
+     * @return The row's glyphs concatenated.
+     */
+    CONSOLETOOLS_INLINE std::string VirtualTerminal::RowText(int Row) const {
+        std::string text;
+        for (int column = 0; column < columns; column++) {
+            text.append(At(Row, column).Glyph);
+        }
+        text.erase(text.find_last_not_of(' ') + 1);
+        return text;
+    }
+
+    /**
+     * @brief Returns the whole screen as text, one line per row, without trailing blank rows.
+     * @return The screen contents.
+     */
+    CONSOLETOOLS_INLINE std::string VirtualTerminal::Text() const {
+        std::string text;
+        for (int row = 0; row < rows; row++) {
+            text.append(RowText(row));
+            text.push_back('\n');
+        }
+        text.erase(text.find_last_not_of('\n') + 1);
+        return text;
+    }
+
+    /**
+     * @brief Compares two screens cell by cell.
+     * @param Other The screen to compare against (typically the expected one).
+     * @return One human-readable line per differing row; empty if the screens are identical.
+     */
+    CONSOLETOOLS_INLINE std::vector<std::string> VirtualTerminal::Diff(const VirtualTerminal& Other) const {
+        std::vector<std::string> differences;
+        if (columns != Other.columns || rows != Other.rows) {
+            differences.push_back("size " + std::to_string(columns) + "x" + std::to_string(rows)
+                + " != " + std::to_string(Other.columns) + "x" + std::to_string(Other.rows));
+            return differences;
+        }
+
+        for (int row = 0; row < rows; row++) {
+            std::string text = RowText(row);
+            std::string otherText = Other.RowText(row);
+            if (text != otherText) {
+                differences.push_back("row " + std::to_string(row) + ": \"" + text + "\" != \"" + otherText + "\"");
+                continue;
+            }
+            for (int column = 0; column < columns; column++) {
+                if (At(row, column) != Other.At(row, column)) {
+                    differences.push_back("row " + std::to_string(row) + ": style differs at column "
+                        + std::to_string(column));
+                    break;
+                }
+            }
+        }
+        return differences;
+    }
+
+    /**
+     * @brief Replays everything recorded by a capture sink.
+     * @param Capture The capture to replay.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void VirtualTerminal::Replay(const CaptureSink& Capture) {
+        Feed(Capture.Bytes());
+    }
+
+    /**
+     * @brief Interprets output bytes. Sequences split across calls are completed by the next call.
+     * @param Bytes The bytes a program wrote to the terminal.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void VirtualTerminal::Feed(std::string_view Bytes) {
+        std::string joined;
+        std::string_view input = Bytes;
+        if (!pending.empty()) {
+            joined = std::move(pending);
+            joined.append(Bytes);
+            pending.clear();
+            input = joined;
+        }
+
+        std::size_t i = 0;
+        while (i < input.size()) {
+            unsigned char c = static_cast<unsigned char>(input[i]);
+
+            if (c == 0x1B) {
+                if (i + 1 >= input.size()) {
+                    pending.assign(input.substr(i));
+                    return;
+                }
+                if (input[i + 1] == '[') {
+                    std::size_t end = i + 2;
+                    while (end < input.size() && !(input[end] >= 0x40 && input[end] <= 0x7E)) {
+                        end++;
+                    }
+                    if (end >= input.size()) {
+                        pending.assign(input.substr(i));
+                        return;
+                    }
+                    ExecuteCsi(input.substr(i + 2, end - i - 2), input[end]);
+                    i = end + 1;
+                }
+                else {
+                    i += detail::EscapeSequenceLength(input, i);
+                }
+                continue;
+            }
+
+            if (c < 0x20 || c == 0x7F) {
+                switch (c) {
+                case '\r':
+                    cursorColumn = 0;
+                    wrapPending = false;
+                    break;
+                case '\n':
+                    cursorColumn = 0;
+                    wrapPending = false;
+                    LineFeed();
+                    break;
+                case '\b':
+                    if (cursorColumn > 0) {
+                        cursorColumn--;
+                    }
+                    wrapPending = false;
+                    break;
+                case '\t':
+                    cursorColumn = std::min((cursorColumn / 8 + 1) * 8, columns - 1);
+                    break;
+                default:
+                    break;
+                }
+                i++;
+                continue;
+            }
+
+            int length = (c < 0x80) ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+            if (i + length > input.size()) {
+                pending.assign(input.substr(i));
+                return;
+            }
+            std::size_t start = i;
+            char32_t codepoint = detail::DecodeUtf8(input, i);
+            PutCodepoint(input.substr(start, i - start), detail::CodepointWidth(codepoint));
+        }
+    }
+
+    CONSOLETOOLS_INLINE void VirtualTerminal::PutCodepoint(std::string_view Glyph, int Width) {
+        if (Width == 0) {
+            // Combining mark: attach to the previously written glyph, stepping back over the
+            // continuation cell of a wide character.
+            int column = wrapPending ? cursorColumn : cursorColumn - 1;
+            while (column > 0 && CellAt(cursorRow, column).Glyph.empty()) {
+                column--;
+            }
+            if (column >= 0) {
+                Cell& previous = CellAt(cursorRow, column);
+                previous.Glyph.append(Glyph);
+            }
+            return;
+        }
+
+        if (wrapPending || (Width == 2 && cursorColumn == columns - 1)) {
+            cursorColumn = 0;
+            wrapPending = false;
+            LineFeed();
+        }
+
+        Cell& cell = CellAt(cursorRow, cursorColumn);
+        cell = pen;
+        cell.Glyph.assign(Glyph);
+        if (Width == 2 && cursorColumn + 1 < columns) {
+            Cell& continuation = CellAt(cursorRow, cursorColumn + 1);
+            continuation = pen;
+            continuation.Glyph.clear();
+        }
+
+        cursorColumn += Width;
+        if (cursorColumn >= columns) {
+            cursorColumn = columns - 1;
+            wrapPending = true;
+        }
+    }
+
+    CONSOLETOOLS_INLINE void VirtualTerminal::LineFeed() {
+        if (cursorRow + 1 < rows) {
+            cursorRow++;
+            return;
+        }
+        // Scroll the screen up by one line.
+        std::move(cells.begin() + columns, cells.end(), cells.begin());
+        std::fill(cells.end() - columns, cells.end(), Cell());
+        scrolledLines++;
+    }
+
+    CONSOLETOOLS_INLINE void VirtualTerminal::EraseCells(int Row, int FromColumn, int ToColumn) {
+        for (int column = std::max(FromColumn, 0); column < std::min(ToColumn, columns); column++) {
+            CellAt(Row, column) = Cell();
+        }
+    }
+
+    CONSOLETOOLS_INLINE void VirtualTerminal::ExecuteCsi(std::string_view Parameters, char Final) {
+        bool isPrivate = !Parameters.empty() && Parameters.front() == '?';
+        if (isPrivate) {
+            Parameters.remove_prefix(1);
+        }
+
+        if (Final == 'm' && !isPrivate) {
+            ApplySgr(Parameters);
+            return;
+        }
+
+        int values[2] = { 0, 0 };
+        int count = 0;
+        for (std::size_t i = 0; i < Parameters.size() && count < 2; i++) {
+            if (Parameters[i] == ';') {
+                count++;
+            }
+            else if (Parameters[i] >= '0' && Parameters[i] <= '9') {
+                values[count] = values[count] * 10 + (Parameters[i] - '0');
+            }
+        }
+        int first = values[0];
+        int amount = (first > 0) ? first : 1;
+
+        if (isPrivate) {
+            if (first == 25 && (Final == 'h' || Final == 'l')) {
+                cursorVisible = (Final == 'h');
+            }
+            return;
+        }
+
+        wrapPending = false;
+        switch (Final) {
+        case 'A':
+            cursorRow = std::max(cursorRow - amount, 0);
+            break;
+        case 'B':
+            cursorRow = std::min(cursorRow + amount, rows - 1);
+            break;
+        case 'C':
+            cursorColumn = std::min(cursorColumn + amount, columns - 1);
+            break;
+        case 'D':
+            cursorColumn = std::max(cursorColumn - amount, 0);
+            break;
+        case 'E':
+            cursorRow = std::min(cursorRow + amount, rows - 1);
+            cursorColumn = 0;
+            break;
+        case 'F':
+            cursorRow = std::max(cursorRow - amount, 0);
+            cursorColumn = 0;
+            break;
+        case 'G':
+            cursorColumn = std::clamp(amount - 1, 0, columns - 1);
+            break;
+        case 'H':
+        case 'f':
+            cursorRow = std::clamp(amount - 1, 0, rows - 1);
+            cursorColumn = std::clamp((values[1] > 0 ? values[1] : 1) - 1, 0, columns - 1);
+            break;
+        case 'J':
+            if (first == 0) {
+                EraseCells(cursorRow, cursorColumn, columns);
+                for (int row = cursorRow + 1; row < rows; row++) {
+                    EraseCells(row, 0, columns);
+                }
+            }
+            else if (first == 1) {
+                for (int row = 0; row < cursorRow; row++) {
+                    EraseCells(row, 0, columns);
+                }
+                EraseCells(cursorRow, 0, cursorColumn + 1);
+            }
+            else {
+                std::fill(cells.begin(), cells.end(), Cell());
+            }
+            break;
+        case 'K':
+            if (first == 0) {
+                EraseCells(cursorRow, cursorColumn, columns);
+            }
+            else if (first == 1) {
+                EraseCells(cursorRow, 0, cursorColumn + 1);
+            }
+            else {
+                EraseCells(cursorRow, 0, columns);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    namespace detail {
+        /**
+         * @brief Applies the parameters of an SGR sequence (the part between "ESC [" and "m") to Pen.
+         * Shared by VirtualTerminal and FrameBuffer so both understand the same colors and attributes.
+         */
+        inline void ApplySgr(VirtualTerminal::Cell& Pen, std::string_view Parameters) {
+            std::vector<int> codes;
+            int value = 0;
+            for (char c : Parameters) {
+                if (c == ';') {
+                    codes.push_back(value);
+                    value = 0;
+                }
+                else if (c >= '0' && c <= '9') {
+                    value = value * 10 + (c - '0');
+                }
+            }
+            codes.push_back(value);
+
+            for (std::size_t i = 0; i < codes.size(); i++) {
+                int code = codes[i];
+                if (code == 0) {
+                    Pen = VirtualTerminal::Cell();
+                }
+                else if (code == 1) {
+                    Pen.Bold = true;
+                }
+                else if (code == 22) {
+                    Pen.Bold = false;
+                }
+                else if (code == 4) {
+                    Pen.Underline = true;
+                }
+                else if (code == 24) {
+                    Pen.Underline = false;
+                }
+                else if (code == 7) {
+                    Pen.Inverse = true;
+                }
+                else if (code == 27) {
+                    Pen.Inverse = false;
+                }
+                else if ((code >= 30 && code <= 37) || (code >= 90 && code <= 97)) {
+                    Pen.Foreground = "\033[" + std::to_string(code) + "m";
+                }
+                else if ((code >= 40 && code <= 47) || (code >= 100 && code <= 107)) {
+                    Pen.Background = "\033[" + std::to_string(code) + "m";
+                }
+                else if (code == 39) {
+                    Pen.Foreground.clear();
+                }
+                else if (code == 49) {
+                    Pen.Background.clear();
+                }
+                else if ((code == 38 || code == 48) && i + 1 < codes.size()) {
+                    // Extended colors: 38;5;n or 38;2;r;g;b (48 for background).
+                    std::size_t extra = (codes[i + 1] == 5) ? 2 : (codes[i + 1] == 2) ? 4 : 0;
+                    if (extra == 0 || i + extra >= codes.size()) {
+                        break;
+                    }
+                    std::string escape = "\033[" + std::to_string(code);
+                    for (std::size_t k = 1; k <= extra; k++) {
+                        escape += ";" + std::to_string(codes[i + k]);
+                    }
+                    escape += "m";
+                    (code == 38 ? Pen.Foreground : Pen.Background) = escape;
+                    i += extra;
+                }
+            }
+        }
+    } // namespace detail
+
+    CONSOLETOOLS_INLINE void VirtualTerminal::ApplySgr(std::string_view Parameters) {
+        detail::ApplySgr(pen, Parameters);
+    }
+
+    namespace detail {
+        /**
+         * @brief Returns this thread's buffer for the *View builders, emptied but with its capacity kept.
+         * Calls alternate between two buffers, so the view returned by the previous call is never the one
+         * being rewritten and can be passed straight into the next call, as in ErrorView(WarningView(...)).
+         * The call after that reuses its memory.
+         */
+        inline std::string& ViewBuffer() {
+            thread_local std::string buffers[2];
+            thread_local int next = 0;
+            std::string& buffer = buffers[next];
+            next ^= 1;
+            buffer.clear();
+            return buffer;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Spacing() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view SpacingView(int NumberOfSpaces) {
+        std::string& spacing = detail::ViewBuffer();
+        detail::AppendSpacing(spacing, NumberOfSpaces);
+        return spacing;
+    }
+
+    /**
+     * @brief Header() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view HeaderView(std::string_view LineCharacter,
+        int LineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor)
+    {
+        std::string& header = detail::ViewBuffer();
+        detail::AppendHeader(header, LineCharacter, LineCharacterCount, HeaderText, SpacingCharacter,
+            LineColor, HeaderTextColor, SpacingCharacterColor);
+        return header;
+    }
+
+    /**
+     * @brief AdvancedHeader() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view AdvancedHeaderView(std::string_view LeftLineCharacter,
+        int LeftLineCharacterCount,
+        std::string_view RightLineCharacter,
+        int RightLineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LeftLineColor,
+        std::string_view RightLineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor,
+        bool ResetColorOnEnd)
+    {
+        std::string& header = detail::ViewBuffer();
+        detail::AppendAdvancedHeader(header, LeftLineCharacter, LeftLineCharacterCount, RightLineCharacter,
+            RightLineCharacterCount, HeaderText, SpacingCharacter, LeftLineColor, RightLineColor,
+            HeaderTextColor, SpacingCharacterColor, ResetColorOnEnd);
+        return header;
+    }
+
+    /**
+     * @brief ProgressBar() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view ProgressBarView(int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        std::string_view BarColor,
+        bool ShowPercentage,
+        std::string_view PercentageColor)
+    {
+        std::string& bar = detail::ViewBuffer();
+        detail::AppendProgressBar(bar, CurrentProgress, MaxProgress, BarWidth, BarColor, ShowPercentage,
+            PercentageColor);
+        return bar;
+    }
+
+    /**
+     * @brief AdvancedProgressBar() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view AdvancedProgressBarView(int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        std::string_view PrefixText,
+        std::string_view SuffixText,
+        std::string_view FillChar,
+        std::string_view UnfilledChar,
+        std::string_view FillColor,
+        std::string_view UnfilledColor,
+        std::string_view TextColor,
+        std::string_view PrefixColor,
+        std::string_view SuffixColor,
+        std::string_view BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion)
+    {
+        std::string& result = detail::ViewBuffer();
+        detail::AppendAdvancedProgressBar(result, CurrentPercentage, MaxPercentage, BarWidth, PrefixText,
+            SuffixText, FillChar, UnfilledChar, FillColor, UnfilledColor, TextColor, PrefixColor, SuffixColor,
+            BracketColor, ShowPercentage, ShowBrackets, ResetColorOnCompletion);
+        return result;
+    }
+
+    /**
+     * @brief Error() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view ErrorView(std::string_view Message) {
+        std::string& error = detail::ViewBuffer();
+        detail::AppendLevelMessage(error, LogLevel::Error, Message);
+        return error;
+    }
+
+    /**
+     * @brief Warning() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view WarningView(std::string_view Message) {
+        std::string& warning = detail::ViewBuffer();
+        detail::AppendLevelMessage(warning, LogLevel::Warning, Message);
+        return warning;
+    }
+
+    /**
+     * @brief Notification() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view NotificationView(std::string_view LeftBorderCharacter,
+        std::string_view InsideCharacter,
+        std::string_view RightBorderCharacter,
+        std::string_view NotificationTypeText,
+        std::string_view NotificationText,
+        std::string_view BorderCharacterColor,
+        std::string_view InsideCharacterColor,
+        std::string_view NotificationTextColor)
+    {
+        std::string& notification = detail::ViewBuffer();
+        detail::AppendNotification(notification, LeftBorderCharacter, InsideCharacter, RightBorderCharacter,
+            NotificationTypeText, NotificationText, BorderCharacterColor, InsideCharacterColor,
+            NotificationTextColor);
+        return notification;
+    }
+
+#if CONSOLETOOLS_HAS_PMR
+    /**
+     * @brief Creates an arena with a buffer of InitialCapacity bytes.
+     * @param InitialCapacity Bytes available to each frame before the arena falls back to the heap.
+     */
+    CONSOLETOOLS_INLINE FrameArena::FrameArena(std::size_t InitialCapacity)
+        : buffer(new std::byte[InitialCapacity > 0 ? InitialCapacity : 1]),
+        capacity(InitialCapacity > 0 ? InitialCapacity : 1)
+    {
+        arena.emplace(buffer.get(), capacity, &upstream);
+    }
+
+    /**
+     * @brief Returns the memory resource to pass to the pmr builders for the current frame.
+     */
+    CONSOLETOOLS_INLINE std::pmr::memory_resource* FrameArena::Resource() {
+        return &*arena;
+    }
+
+    /**
+     * @brief Frees everything allocated since the last Reset(). Strings built from Resource()
+     * must not be used afterwards. If the frame overflowed, the buffer grows to fit it.
+     */
+    CONSOLETOOLS_INLINE void FrameArena::Reset() {
+        arena.reset();
+
+        if (upstream.Bytes > 0) {
+            capacity += upstream.Bytes;
+            buffer.reset(new std::byte[capacity]);
+        }
+        upstream.Bytes = 0;
+        upstream.Allocations = 0;
+
+        arena.emplace(buffer.get(), capacity, &upstream);
+    }
+
+    CONSOLETOOLS_INLINE void* FrameArena::CountingResource::do_allocate(std::size_t Size, std::size_t Alignment) {
+        Bytes += Size;
+        Allocations++;
+        return std::pmr::new_delete_resource()->allocate(Size, Alignment);
+    }
+
+    CONSOLETOOLS_INLINE void FrameArena::CountingResource::do_deallocate(void* Pointer, std::size_t Size,
+        std::size_t Alignment)
+    {
+        std::pmr::new_delete_resource()->deallocate(Pointer, Size, Alignment);
+    }
+
+    CONSOLETOOLS_INLINE bool FrameArena::CountingResource::do_is_equal(const std::pmr::memory_resource& Other) const noexcept {
+        return this == &Other;
+    }
+
+    /**
+     * @brief Spacing() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string Spacing(std::pmr::memory_resource* Resource, int NumberOfSpaces) {
+        std::pmr::string spacing(Resource);
+        detail::AppendSpacing(spacing, NumberOfSpaces);
+        return spacing;
+    }
+
+    /**
+     * @brief Header() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string Header(std::pmr::memory_resource* Resource,
+        std::string_view LineCharacter,
+        int LineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor)
+    {
+        std::pmr::string header(Resource);
+        detail::AppendHeader(header, LineCharacter, LineCharacterCount, HeaderText, SpacingCharacter,
+            LineColor, HeaderTextColor, SpacingCharacterColor);
+        return header;
+    }
+
+    /**
+     * @brief AdvancedHeader() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string AdvancedHeader(std::pmr::memory_resource* Resource,
+        std::string_view LeftLineCharacter,
+        int LeftLineCharacterCount,
+        std::string_view RightLineCharacter,
+        int RightLineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LeftLineColor,
+        std::string_view RightLineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor,
+        bool ResetColorOnEnd)
+    {
+        std::pmr::string header(Resource);
+        detail::AppendAdvancedHeader(header, LeftLineCharacter, LeftLineCharacterCount, RightLineCharacter,
+            RightLineCharacterCount, HeaderText, SpacingCharacter, LeftLineColor, RightLineColor,
+            HeaderTextColor, SpacingCharacterColor, ResetColorOnEnd);
+        return header;
+    }
+
+    /**
+     * @brief ProgressBar() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string ProgressBar(std::pmr::memory_resource* Resource,
+        int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        std::string_view BarColor,
+        bool ShowPercentage,
+        std::string_view PercentageColor)
+    {
+        std::pmr::string bar(Resource);
+        detail::AppendProgressBar(bar, CurrentProgress, MaxProgress, BarWidth, BarColor, ShowPercentage,
+            PercentageColor);
+        return bar;
+    }
+
+    /**
+     * @brief AdvancedProgressBar() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string AdvancedProgressBar(std::pmr::memory_resource* Resource,
+        int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        std::string_view PrefixText,
+        std::string_view SuffixText,
+        std::string_view FillChar,
+        std::string_view UnfilledChar,
+        std::string_view FillColor,
+        std::string_view UnfilledColor,
+        std::string_view TextColor,
+        std::string_view PrefixColor,
+        std::string_view SuffixColor,
+        std::string_view BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion)
+    {
+        std::pmr::string result(Resource);
+        detail::AppendAdvancedProgressBar(result, CurrentPercentage, MaxPercentage, BarWidth, PrefixText,
+            SuffixText, FillChar, UnfilledChar, FillColor, UnfilledColor, TextColor, PrefixColor, SuffixColor,
+            BracketColor, ShowPercentage, ShowBrackets, ResetColorOnCompletion);
+        return result;
+    }
+
+    /**
+     * @brief Error() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string Error(std::pmr::memory_resource* Resource, std::string_view Message) {
+        std::pmr::string error(Resource);
+        detail::AppendLevelMessage(error, LogLevel::Error, Message);
+        return error;
+    }
+
+    /**
+     * @brief Warning() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string Warning(std::pmr::memory_resource* Resource, std::string_view Message) {
+        std::pmr::string warning(Resource);
+        detail::AppendLevelMessage(warning, LogLevel::Warning, Message);
+        return warning;
+    }
+
+    /**
+     * @brief Notification() allocated from Resource.
+     */
+    CONSOLETOOLS_INLINE std::pmr::string Notification(std::pmr::memory_resource* Resource,
+        std::string_view LeftBorderCharacter,
+        std::string_view InsideCharacter,
+        std::string_view RightBorderCharacter,
+        std::string_view NotificationTypeText,
+        std::string_view NotificationText,
+        std::string_view BorderCharacterColor,
+        std::string_view InsideCharacterColor,
+        std::string_view NotificationTextColor)
+    {
+        std::pmr::string notification(Resource);
+        detail::AppendNotification(notification, LeftBorderCharacter, InsideCharacter, RightBorderCharacter,
+            NotificationTypeText, NotificationText, BorderCharacterColor, InsideCharacterColor,
+            NotificationTextColor);
+        return notification;
+    }
+#endif
+
+
+    /**
+     * @brief Creates a group with room for Capacity spinners. Nothing is drawn until Start() or Render().
+     * @param Capacity The maximum number of spinners.
+     * @param Interval Time between animation frames.
+     */
+    CONSOLETOOLS_INLINE SpinnerGroup::SpinnerGroup(int Capacity, std::chrono::milliseconds Interval)
+        : slots(new Slot[Capacity > 0 ? Capacity : 1]),
+        capacity(Capacity > 0 ? Capacity : 1),
+        interval(Interval.count() > 0 ? Interval : std::chrono::milliseconds(1)),
+        monitor(interval)
+    {
+    }
+
+    /**
+     * @brief Stops the timer thread if it is still running.
+     */
+    CONSOLETOOLS_INLINE SpinnerGroup::~SpinnerGroup() {
+        Stop();
+    }
+
+    /**
+     * @brief Adds a spinner. May be called while the group is running.
+     * @param Row Lines above the cursor line (0 = the cursor line).
+     * @param Column 1-based column of the spinner's first cell.
+     * @param Frames The animation to use (see Spinners).
+     * @param SpinnerColor Color code for the spinner.
+     * @return The spinner's index, or -1 if the group is full.
+     */
+    CONSOLETOOLS_INLINE int SpinnerGroup::Add(int Row, int Column, const SpinnerFrames& Frames,
+        std::string_view SpinnerColor)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int index = count.load(std::memory_order_relaxed);
+        if (index >= capacity || Frames.Count <= 0) {
+            return -1;
+        }
+
+        Slot& slot = slots[index];
+        slot.Row = std::max(Row, 0);
+        slot.Column = std::max(Column, 1);
+        slot.Frames = Frames;
+        slot.Width = 0;
+        for (int i = 0; i < Frames.Count; i++) {
+            slot.Width = std::max(slot.Width, VisibleWidth(Frames.Frames[i]));
+        }
+
+        // Column positioning and color never change, so they are rendered once here.
+        slot.Style = "\033[" + std::to_string(slot.Column) + "G";
+        slot.Style.append(SpinnerColor);
+
+        count.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+    /**
+     * @brief Replaces a spinner's label without taking any lock. Labels longer than LabelCapacity bytes are cut.
+     * @param Spinner Index returned by Add().
+     * @param Label Text shown one space after the spinner.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::SetLabel(int Spinner, std::string_view Label) {
+        if (Spinner < 0 || Spinner >= count.load(std::memory_order_acquire)) {
+            return;
+        }
+        Slot& slot = slots[Spinner];
+
+        std::size_t length = std::min(Label.size(), LabelCapacity);
+        while (length > 0 && length < Label.size() && (static_cast<unsigned char>(Label[length]) & 0xC0) == 0x80) {
+            length--; // do not cut a UTF-8 sequence in half
+        }
+        char bytes[LabelCapacity] = {};
+        std::memcpy(bytes, Label.data(), length);
+
+        // An odd sequence number marks a write in progress; readers retry until it is even and unchanged.
+        std::uint32_t sequence = slot.labelSequence.load(std::memory_order_relaxed);
+        do {
+            while (sequence & 1) {
+                sequence = slot.labelSequence.load(std::memory_order_relaxed);
+            }
+        } while (!slot.labelSequence.compare_exchange_weak(sequence, sequence + 1,
+            std::memory_order_acquire, std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < LabelWords; i++) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+            slot.labelWords[i].store(word, std::memory_order_relaxed);
+        }
+        slot.labelLength.store(static_cast<std::uint32_t>(length), std::memory_order_relaxed);
+        slot.labelSequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Stops animating a spinner and shows FinalText in its place (for example a check mark).
+     * @param Spinner Index returned by Add().
+     * @param FinalText Text drawn instead of the spinner from the next frame on.
+     * @param FinalColor Color code for FinalText.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::Complete(int Spinner, std::string_view FinalText, std::string_view FinalColor) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (Spinner < 0 || Spinner >= count.load(std::memory_order_relaxed)) {
+            return;
+        }
+        Slot& slot = slots[Spinner];
+        slot.FinalText.assign(FinalColor);
+        slot.FinalText.append(FinalText);
+        slot.Completed = true;
+        slot.FinalDrawn = false;
+    }
+
+    /**
+     * @brief Hides the cursor and starts the timer thread that draws a frame every interval.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::Start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            return;
+        }
+        running = true;
+        stopRequested = false;
+        HideCursor();
+
+        timer = std::thread([this]() {
+            Clock& clock = GetClock();
+            std::unique_lock<std::mutex> timerLock(mutex);
+            auto next = clock.Now();
+            while (!stopRequested) {
+                timerLock.unlock();
+                DrawFrame(false, true);
+                timerLock.lock();
+                next += interval;
+                while (!stopRequested && clock.Now() < next) {
+                    clock.FollowUntil(wake, timerLock, next);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Stops the timer thread, draws the final state of every spinner and shows the cursor again.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) {
+                return;
+            }
+            stopRequested = true;
+        }
+        wake.notify_all();
+        timer.join();
+
+        DrawFrame(true, false);
+        ShowCursor();
+        FlushOutput();
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+
+    /**
+     * @brief Draws one frame immediately. Useful without Start() to drive the animation from your own loop.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::Render() {
+        DrawFrame(false, false);
+    }
+
+    /**
+     * @brief Builds a frame under the group's lock and writes it after releasing it, so a slow write
+     * never holds up Add() or Complete().
+     * @param Final Draw the last frame (see RenderLocked()).
+     * @param Paced Ask the FrameMonitor first and skip the frame if the output is behind.
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::DrawFrame(bool Final, bool Paced) {
+        std::lock_guard<std::mutex> drawLock(drawMutex);
+        Clock& clock = GetClock();
+        OutputSink& sink = GetOutputSink();
+        if (Paced && !monitor.ShouldDraw(clock.Now(), sink.PendingBytes())) {
+            if (sink.PendingBytes() > 0) {
+                // Keep the backlog moving without adding to it.
+                sink.Flush();
+            }
+            return;
+        }
+
+        CONSOLETOOLS_MEASURE(Metric::SpinnerFrame);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            RenderLocked(Final);
+        }
+        if (frame.empty()) {
+            return;
+        }
+
+        CONSOLETOOLS_MEASURE_BYTES(frame.size());
+        Clock::TimePoint start = clock.Now();
+        Print(frame);
+        FlushOutput();
+        if (Paced) {
+            monitor.FrameWritten(start, clock.Now(), sink.PendingBytes());
+        }
+    }
+
+    /**
+     * @brief Appends the cursor movement from FromRow to ToRow (rows counted upwards from the cursor line).
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::AppendMove(int FromRow, int ToRow) {
+        if (ToRow == FromRow) {
+            return;
+        }
+        char move[16];
+        int length = std::snprintf(move, sizeof(move), "\033[%d%c", ToRow > FromRow ? ToRow - FromRow : FromRow - ToRow,
+            ToRow > FromRow ? 'A' : 'B');
+        frame.append(move, static_cast<std::size_t>(length));
+    }
+
+    /**
+     * @brief Builds the next frame for every spinner that needs drawing into frame (left empty if none does).
+     * @param Final Draw the last frame: spinners stay where they are instead of advancing.
+     */
+    CONSOLETOOLS_INLINE void SpinnerGroup::RenderLocked(bool Final) {
+        frame.clear();
+        int spinners = count.load(std::memory_order_acquire);
+        int currentRow = 0;
+
+        for (int i = 0; i < spinners; i++) {
+            Slot& slot = slots[i];
+            bool labelChanged = slot.labelSequence.load(std::memory_order_acquire) != slot.drawnSequence;
+            if (slot.Completed && slot.FinalDrawn && !labelChanged) {
+                continue;
+            }
+
+            AppendMove(currentRow, slot.Row);
+            currentRow = slot.Row;
+            frame.append(slot.Style);
+
+            int glyphWidth = slot.Width;
+            if (slot.Completed) {
+                frame.append(slot.FinalText);
+                glyphWidth = VisibleWidth(slot.FinalText);
+                slot.FinalDrawn = true;
+            }
+            else {
+                frame.append(slot.Frames.Frames[tick % static_cast<std::uint64_t>(slot.Frames.Count)]);
+            }
+            frame.append(Color::RESET);
+            frame.append(static_cast<std::size_t>(std::max(slot.Width - glyphWidth, 0)), ' ');
+
+            if (labelChanged || slot.Completed) {
+                char text[LabelCapacity];
+                std::uint32_t sequence;
+                std::uint32_t length;
+                for (;;) {
+                    sequence = slot.labelSequence.load(std::memory_order_acquire);
+                    if (sequence & 1) {
+                        continue;
+                    }
+                    length = slot.labelLength.load(std::memory_order_relaxed);
+                    for (std::size_t w = 0; w < LabelWords; w++) {
+                        std::uint64_t word = slot.labelWords[w].load(std::memory_order_relaxed);
+                        std::memcpy(text + w * sizeof(word), &word, sizeof(word));
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.labelSequence.load(std::memory_order_relaxed) == sequence) {
+                        break;
+                    }
+                }
+
+                std::string_view label(text, std::min<std::size_t>(length, LabelCapacity));
+                int labelWidth = VisibleWidth(label);
+                frame.push_back(' ');
+                frame.append(label);
+                // Blank out the rest of a longer previous label without touching anything further right.
+                frame.append(static_cast<std::size_t>(std::max(slot.drawnLabelWidth - labelWidth, 0)), ' ');
+                slot.drawnSequence = sequence;
+                slot.drawnLabelWidth = labelWidth;
+            }
+        }
+
+        if (frame.empty()) {
+            return;
+        }
+        AppendMove(currentRow, 0);
+        frame.push_back('\r');
+        if (!Final) {
+            tick++;
+        }
+    }
+
+
+    namespace detail {
+        // The span reductions use four independent accumulators so the compiler can keep them
+        // in vector registers; a single running value would serialize every step on the last one.
+
+        inline double SpanSum(const double* Values, std::size_t Count) {
+            double a = 0.0, b = 0.0, c = 0.0, d = 0.0;
+            std::size_t i = 0;
+            for (; i + 4 <= Count; i += 4) {
+                a += Values[i];
+                b += Values[i + 1];
+                c += Values[i + 2];
+                d += Values[i + 3];
+            }
+            for (; i < Count; i++) {
+                a += Values[i];
+            }
+            return (a + b) + (c + d);
+        }
+
+        inline double SpanMax(const double* Values, std::size_t Count) {
+            double a = -std::numeric_limits<double>::infinity();
+            double b = a, c = a, d = a;
+            std::size_t i = 0;
+            for (; i + 4 <= Count; i += 4) {
+                a = Values[i] > a ? Values[i] : a;
+                b = Values[i + 1] > b ? Values[i + 1] : b;
+                c = Values[i + 2] > c ? Values[i + 2] : c;
+                d = Values[i + 3] > d ? Values[i + 3] : d;
+            }
+            for (; i < Count; i++) {
+                a = Values[i] > a ? Values[i] : a;
+            }
+            return std::max(std::max(a, b), std::max(c, d));
+        }
+
+        inline double SpanMin(const double* Values, std::size_t Count) {
+            double a = std::numeric_limits<double>::infinity();
+            double b = a, c = a, d = a;
+            std::size_t i = 0;
+            for (; i + 4 <= Count; i += 4) {
+                a = Values[i] < a ? Values[i] : a;
+                b = Values[i + 1] < b ? Values[i + 1] : b;
+                c = Values[i + 2] < c ? Values[i + 2] : c;
+                d = Values[i + 3] < d ? Values[i + 3] : d;
+            }
+            for (; i < Count; i++) {
+                a = Values[i] < a ? Values[i] : a;
+            }
+            return std::min(std::min(a, b), std::min(c, d));
+        }
+    } // namespace detail
+
+    /**
+     * @brief Creates an empty buffer that keeps the latest Capacity samples.
+     * @param Capacity How many samples to keep (at least 1).
+     */
+    CONSOLETOOLS_INLINE SeriesBuffer::SeriesBuffer(std::size_t Capacity)
+        : values(Capacity > 0 ? Capacity : 1, 0.0),
+        capacity(Capacity > 0 ? Capacity : 1),
+        minQueue(capacity),
+        maxQueue(capacity)
+    {
+    }
+
+    /**
+     * @brief Appends a sample, dropping the oldest one if the buffer is full.
+     * @param Value The sample. NaN and infinities are ignored, since they would leave the charts no scale.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SeriesBuffer::Push(double Value) {
+        if (!std::isfinite(Value)) {
+            return;
+        }
+
+        if (size == capacity) {
+            // The oldest sample is about to be overwritten; it can only be at the front of a queue.
+            if (minCount > 0 && minQueue[minHead] == next) {
+                minHead = Wrap(minHead + 1);
+                minCount--;
+            }
+            if (maxCount > 0 && maxQueue[maxHead] == next) {
+                maxHead = Wrap(maxHead + 1);
+                maxCount--;
+            }
+        }
+        else {
+            size++;
+        }
+        values[next] = Value;
+
+        while (minCount > 0 && values[minQueue[Wrap(minHead + minCount - 1)]] >= Value) {
+            minCount--;
+        }
+        minQueue[Wrap(minHead + minCount)] = next;
+        minCount++;
+
+        while (maxCount > 0 && values[maxQueue[Wrap(maxHead + maxCount - 1)]] <= Value) {
+            maxCount--;
+        }
+        maxQueue[Wrap(maxHead + maxCount)] = next;
+        maxCount++;
+
+        next = Wrap(next + 1);
+    }
+
+    /**
+     * @brief Removes every sample.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void SeriesBuffer::Clear() {
+        size = 0;
+        next = 0;
+        minHead = 0;
+        minCount = 0;
+        maxHead = 0;
+        maxCount = 0;
+    }
+
+    /**
+     * @brief Combines the samples First to Last - 1 (0 = oldest) into one value.
+     */
+    CONSOLETOOLS_INLINE double SeriesBuffer::Reduce(std::size_t First, std::size_t Last, SeriesAggregate Aggregate) const {
+        // The range is at most two contiguous pieces of the ring.
+        std::size_t start = Wrap(Oldest() + First);
+        std::size_t count = Last - First;
+        std::size_t head = std::min(count, capacity - start);
+        std::size_t tail = count - head;
+        const double* data = values.data();
+
+        switch (Aggregate) {
+        case SeriesAggregate::Mean:
+            return (detail::SpanSum(data + start, head) + detail::SpanSum(data, tail)) / static_cast<double>(count);
+        case SeriesAggregate::Min:
+            return std::min(detail::SpanMin(data + start, head), detail::SpanMin(data, tail));
+        default:
+            return std::max(detail::SpanMax(data + start, head), detail::SpanMax(data, tail));
+        }
+    }
+
+    /**
+     * @brief Fits the series into Columns values, oldest first. A series longer than Columns is split
+     * into Columns equal buckets that are each combined with Aggregate; a shorter one is copied as is.
+     * @param Out Receives up to Columns values.
+     * @param Columns The number of columns available.
+     * @param Aggregate How to combine the samples of one bucket.
+     * @return The number of values written: min(Size(), Columns).
+     */
+    CONSOLETOOLS_INLINE std::size_t SeriesBuffer::Downsample(double* Out, std::size_t Columns, SeriesAggregate Aggregate) const {
+        if (Columns == 0 || size == 0) {
+            return 0;
+        }
+        if (size <= Columns) {
+            for (std::size_t i = 0; i < size; i++) {
+                Out[i] = (*this)[i];
+            }
+            return size;
+        }
+        for (std::size_t column = 0; column < Columns; column++) {
+            Out[column] = Reduce(column * size / Columns, (column + 1) * size / Columns, Aggregate);
+        }
+        return Columns;
+    }
+
+    namespace detail {
+        /**
+         * @brief Downsamples Series into this thread's column scratch buffer.
+         * @return The columns; fewer than Width while the series is shorter than the chart.
+         */
+        inline const std::vector<double>& ChartColumns(const SeriesBuffer& Series, int Width, SeriesAggregate Aggregate) {
+            thread_local std::vector<double> columns;
+            columns.resize(static_cast<std::size_t>(Width));
+            columns.resize(Series.Downsample(columns.data(), columns.size(), Aggregate));
+            return columns;
+        }
+
+        template <typename String>
+        void AppendSparkline(String& Out,
+            const SeriesBuffer& Series,
+            int Width,
+            std::string_view SparklineColor,
+            SeriesAggregate Aggregate)
+        {
+            if (Width == FILL_AVAILABLE_WIDTH) {
+                Width = FillCount(0, 1);
+            }
+            if (Width <= 0) {
+                return;
+            }
+
+            const std::vector<double>& columns = ChartColumns(Series, Width, Aggregate);
+            // Right-align, so the latest sample always sits in the last column.
+            Out.append(static_cast<std::size_t>(Width) - columns.size(), ' ');
+            Out.append(SparklineColor);
+            double low = Series.Min();
+            double range = Series.Max() - low;
+            for (double value : columns) {
+                int level = (range > 0.0) ? static_cast<int>((value - low) / range * 7.0 + 0.5) : 3;
+                Out.append(BlockEighths[std::clamp(level, 0, 7) + 1]);
+            }
+            Out.append(Color::RESET);
+        }
+
+        template <typename String>
+        void AppendMiniBarChart(String& Out,
+            const SeriesBuffer& Series,
+            int Width,
+            int Height,
+            std::string_view BarColor,
+            SeriesAggregate Aggregate)
+        {
+            if (Width == FILL_AVAILABLE_WIDTH) {
+                Width = FillCount(0, 1);
+            }
+            if (Width <= 0 || Height <= 0) {
+                return;
+            }
+
+            const std::vector<double>& columns = ChartColumns(Series, Width, Aggregate);
+            thread_local std::vector<int> heights;
+            heights.resize(columns.size());
+
+            // Bars start at zero unless the series goes negative. Heights are in eighths of a row.
+            double low = std::min(0.0, Series.Min());
+            double high = Series.Max();
+            double range = high - low;
+            int fullHeight = Height * 8;
+            for (std::size_t i = 0; i < columns.size(); i++) {
+                heights[i] = (range > 0.0) ? static_cast<int>((columns[i] - low) / range * fullHeight + 0.5)
+                    : (high > 0.0 ? fullHeight : 0);
+            }
+
+            for (int row = 0; row < Height; row++) {
+                if (row > 0) {
+                    Out.push_back('\n');
+                }
+                Out.append(static_cast<std::size_t>(Width) - columns.size(), ' ');
+                Out.append(BarColor);
+                int base = (Height - 1 - row) * 8;
+                for (int height : heights) {
+                    Out.append(BlockEighths[std::clamp(height - base, 0, 8)]);
+                }
+                Out.append(Color::RESET);
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Renders a series as a one-line sparkline of eighth blocks scaled between its minimum and maximum.
+     * @param Series The samples to draw.
+     * @param Width Columns to use, or FILL_AVAILABLE_WIDTH. Longer series are downsampled.
+     * @param SparklineColor Color code for the sparkline.
+     * @param Aggregate How to combine samples that share a column.
+     * @return The sparkline, exactly Width columns wide (right-aligned while the series is shorter).
+     */
+    CONSOLETOOLS_INLINE std::string Sparkline(const SeriesBuffer& Series,
+        int Width,
+        std::string_view SparklineColor,
+        SeriesAggregate Aggregate)
+    {
+        std::string sparkline;
+        detail::AppendSparkline(sparkline, Series, Width, SparklineColor, Aggregate);
+        return sparkline;
+    }
+
+    /**
+     * @brief Sparkline() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view SparklineView(const SeriesBuffer& Series,
+        int Width,
+        std::string_view SparklineColor,
+        SeriesAggregate Aggregate)
+    {
+        std::string& sparkline = detail::ViewBuffer();
+        detail::AppendSparkline(sparkline, Series, Width, SparklineColor, Aggregate);
+        return sparkline;
+    }
+
+    /**
+     * @brief Renders a series as a bar chart Height lines tall, with eighth-block resolution.
+     * Bars start at zero, or at the series minimum if it is negative.
+     * @param Series The samples to draw.
+     * @param Width Columns to use, or FILL_AVAILABLE_WIDTH. Longer series are downsampled.
+     * @param Height Lines to use.
+     * @param BarColor Color code for the bars.
+     * @param Aggregate How to combine samples that share a column.
+     * @return The chart's lines, separated by '\n' (no trailing newline).
+     */
+    CONSOLETOOLS_INLINE std::string MiniBarChart(const SeriesBuffer& Series,
+        int Width,
+        int Height,
+        std::string_view BarColor,
+        SeriesAggregate Aggregate)
+    {
+        std::string chart;
+        detail::AppendMiniBarChart(chart, Series, Width, Height, BarColor, Aggregate);
+        return chart;
+    }
+
+    /**
+     * @brief MiniBarChart() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view MiniBarChartView(const SeriesBuffer& Series,
+        int Width,
+        int Height,
+        std::string_view BarColor,
+        SeriesAggregate Aggregate)
+    {
+        std::string& chart = detail::ViewBuffer();
+        detail::AppendMiniBarChart(chart, Series, Width, Height, BarColor, Aggregate);
+        return chart;
+    }
+
+    namespace detail {
+        /**
+         * @brief Returns a small number that is different for every thread, for picking a shard.
+         */
+        inline std::size_t ThreadShardIndex() {
+            static std::atomic<std::size_t> nextIndex{ 0 };
+            thread_local std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Creates an empty histogram.
+     * @param Shards Number of shards (rounded up to a power of two, at most 256), or 0 for one per hardware thread.
+     */
+    CONSOLETOOLS_INLINE ConcurrentHistogram::ConcurrentHistogram(int Shards)
+        : shardMask(0)
+    {
+        std::size_t wanted = (Shards > 0) ? static_cast<std::size_t>(Shards)
+            : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        std::size_t count = 1;
+        while (count < wanted && count < 256) {
+            count <<= 1;
+        }
+        shardMask = count - 1;
+        buckets.reset(new std::atomic<std::uint64_t>[count * LogLinearHistogram::BucketCount]());
+    }
+
+    /**
+     * @brief Records Value, Count times. Safe to call from any number of threads at once.
+     * @param Value The value to record.
+     * @param Count How many times it occurred.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void ConcurrentHistogram::Record(std::uint64_t Value, std::uint64_t Count) {
+        std::size_t shard = detail::ThreadShardIndex() & shardMask;
+        buckets[shard * LogLinearHistogram::BucketCount + static_cast<std::size_t>(LogLinearHistogram::BucketIndex(Value))]
+            .fetch_add(Count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Merges the shards into a plain histogram. Recording may continue meanwhile.
+     * @return Everything recorded since construction or the last TakeInterval() or Clear().
+     */
+    CONSOLETOOLS_INLINE LogLinearHistogram ConcurrentHistogram::Snapshot() const {
+        LogLinearHistogram snapshot;
+        for (int b = 0; b < LogLinearHistogram::BucketCount; b++) {
+            std::uint64_t count = 0;
+            for (std::size_t shard = 0; shard <= shardMask; shard++) {
+                count += buckets[shard * LogLinearHistogram::BucketCount + static_cast<std::size_t>(b)].load(std::memory_order_relaxed);
+            }
+            snapshot.RecordBucket(b, count);
+        }
+        return snapshot;
+    }
+
+    /**
+     * @brief Like Snapshot(), but also starts a new interval: every sample is returned by exactly one call.
+     * Feed the results to a HistogramHeatmap to show the distribution over time.
+     * @return Everything recorded since the previous call.
+     */
+    CONSOLETOOLS_INLINE LogLinearHistogram ConcurrentHistogram::TakeInterval() {
+        LogLinearHistogram interval;
+        for (int b = 0; b < LogLinearHistogram::BucketCount; b++) {
+            std::uint64_t count = 0;
+            for (std::size_t shard = 0; shard <= shardMask; shard++) {
+                count += buckets[shard * LogLinearHistogram::BucketCount + static_cast<std::size_t>(b)].exchange(0, std::memory_order_relaxed);
+            }
+            interval.RecordBucket(b, count);
+        }
+        return interval;
+    }
+
+    /**
+     * @brief Forgets every recorded value.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void ConcurrentHistogram::Clear() {
+        std::size_t total = (shardMask + 1) * LogLinearHistogram::BucketCount;
+        for (std::size_t i = 0; i < total; i++) {
+            buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    namespace detail {
+        constexpr int HistogramLabelWidth = 7;
+
+        /**
+         * @brief Formats Value compactly (at most HistogramLabelWidth columns), for example "12.3ms" or "4.5M".
+         * @return The label's visible width.
+         */
+        inline int FormatHistogramLabel(char (&Label)[24], std::uint64_t Value, HistogramLabels Labels) {
+            static constexpr const char* NanosecondUnits[] = { "ns", "\xC2\xB5s", "ms", "s" };
+            static constexpr const char* PlainUnits[] = { "", "k", "M", "G" };
+            const char* const* units = (Labels == HistogramLabels::Nanoseconds) ? NanosecondUnits : PlainUnits;
+
+            int unit = 0;
+            double scaled = static_cast<double>(Value);
+            while (scaled >= 1000.0 && unit < 3) {
+                scaled /= 1000.0;
+                unit++;
+            }
+
+            int length;
+            if (unit == 0) {
+                length = std::snprintf(Label, sizeof(Label), "%llu%s", static_cast<unsigned long long>(Value), units[0]);
+            }
+            else {
+                const char* format = (scaled < 10.0) ? "%.2f%s" : (scaled < 100.0) ? "%.1f%s" : "%.0f%s";
+                length = std::snprintf(Label, sizeof(Label), format, scaled, units[unit]);
+            }
+            // The micro sign in "\xC2\xB5s" is two bytes but one column.
+            return (Labels == HistogramLabels::Nanoseconds && unit == 1) ? length - 1 : length;
+        }
+
+        template <typename String>
+        void AppendHistogramLabel(String& Out, std::uint64_t Value, HistogramLabels Labels) {
+            char label[24];
+            int width = FormatHistogramLabel(label, Value, Labels);
+            Out.append(static_cast<std::size_t>(std::max(HistogramLabelWidth - width, 0)), ' ');
+            Out.append(label);
+        }
+
+        template <typename String>
+        void AppendHistogramBars(String& Out,
+            const LogLinearHistogram& Histogram,
+            int Rows,
+            int BarWidth,
+            std::string_view BarColor,
+            std::string_view LabelColor,
+            HistogramLabels Labels)
+        {
+            if (Histogram.Count() == 0 || Rows <= 0) {
+                return;
+            }
+            if (BarWidth == FILL_AVAILABLE_WIDTH) {
+                // Label, bar, and room for a count of up to 12 digits.
+                BarWidth = FillCount(HistogramLabelWidth + 2 + 12, 1);
+            }
+            BarWidth = std::max(BarWidth, 1);
+
+            // Rows split the occupied buckets evenly, which keeps them log-linear like the buckets.
+            int first = LogLinearHistogram::BucketIndex(Histogram.Min());
+            int last = LogLinearHistogram::BucketIndex(Histogram.Max());
+            int span = last - first + 1;
+            Rows = std::min(Rows, span);
+
+            thread_local std::vector<std::uint64_t> rowCounts;
+            rowCounts.assign(static_cast<std::size_t>(Rows), 0);
+            std::uint64_t largest = 0;
+            for (int row = 0; row < Rows; row++) {
+                for (int b = first + row * span / Rows; b < first + (row + 1) * span / Rows; b++) {
+                    rowCounts[static_cast<std::size_t>(row)] += Histogram.BucketValue(b);
+                }
+                largest = std::max(largest, rowCounts[static_cast<std::size_t>(row)]);
+            }
+
+            for (int row = 0; row < Rows; row++) {
+                if (row > 0) {
+                    Out.push_back('\n');
+                }
+                int rowLast = first + (row + 1) * span / Rows - 1;
+                std::uint64_t upper = std::min(LogLinearHistogram::BucketUpperBound(rowLast) - 1, Histogram.Max());
+                Out.append(LabelColor);
+                AppendHistogramLabel(Out, upper, Labels);
+                Out.push_back(' ');
+
+                std::uint64_t count = rowCounts[static_cast<std::size_t>(row)];
+                int eighths = static_cast<int>(static_cast<double>(count) / static_cast<double>(largest) * BarWidth * 8 + 0.5);
+                if (count > 0) {
+                    eighths = std::max(eighths, 1);
+                }
+                Out.append(BarColor);
+                AppendRepeated(Out, HorizontalEighths[8], eighths / 8);
+                Out.append(HorizontalEighths[eighths % 8]);
+                Out.append(static_cast<std::size_t>(BarWidth - eighths / 8 - (eighths % 8 ? 1 : 0)), ' ');
+                Out.append(Color::RESET);
+                Out.push_back(' ');
+
+                char number[24];
+                int length = std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(count));
+                Out.append(number, static_cast<std::size_t>(length));
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Renders a histogram as horizontal bars, smallest values at the top. Each line shows the
+     * largest value of its range, a bar proportional to its count, and the count.
+     * @param Histogram The distribution to draw.
+     * @param Rows Maximum number of lines. The occupied buckets are split evenly among them.
+     * @param BarWidth Columns of the longest bar, or FILL_AVAILABLE_WIDTH.
+     * @param BarColor Color code for the bars.
+     * @param LabelColor Color code for the value labels.
+     * @param Labels How to format the values.
+     * @return The lines, separated by '\n' (no trailing newline), or an empty string for an empty histogram.
+     */
+    CONSOLETOOLS_INLINE std::string HistogramBars(const LogLinearHistogram& Histogram,
+        int Rows,
+        int BarWidth,
+        std::string_view BarColor,
+        std::string_view LabelColor,
+        HistogramLabels Labels)
+    {
+        std::string bars;
+        detail::AppendHistogramBars(bars, Histogram, Rows, BarWidth, BarColor, LabelColor, Labels);
+        return bars;
+    }
+
+    /**
+     * @brief HistogramBars() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view HistogramBarsView(const LogLinearHistogram& Histogram,
+        int Rows,
+        int BarWidth,
+        std::string_view BarColor,
+        std::string_view LabelColor,
+        HistogramLabels Labels)
+    {
+        std::string& bars = detail::ViewBuffer();
+        detail::AppendHistogramBars(bars, Histogram, Rows, BarWidth, BarColor, LabelColor, Labels);
+        return bars;
+    }
+
+    /**
+     * @brief Creates an empty heatmap.
+     * @param Columns Width in cells; each shows two slices.
+     * @param Rows Height in cells; each covers four value bands.
+     * @param MinValue Value at the bottom edge (at least 1). Smaller values land in the lowest band.
+     * @param MaxValue Value at the top edge. Larger values land in the highest band.
+     * @param Palette Color codes from the lowest to the highest share, or empty for blue to red.
+     */
+    CONSOLETOOLS_INLINE HistogramHeatmap::HistogramHeatmap(int Columns, int Rows, std::uint64_t MinValue,
+        std::uint64_t MaxValue, std::vector<std::string> Palette)
+        : columns(std::max(Columns, 1)),
+        rows(std::max(Rows, 1)),
+        bands(rows * 4),
+        minValue(std::max<std::uint64_t>(MinValue, 1)),
+        maxValue(std::max<std::uint64_t>(MaxValue, minValue + 1)),
+        logMin(std::log(static_cast<double>(minValue))),
+        bandsPerLog(bands / (std::log(static_cast<double>(maxValue)) - logMin)),
+        palette(std::move(Palette)),
+        shares(static_cast<std::size_t>(columns) * 2 * static_cast<std::size_t>(bands), 0.0f)
+    {
+        if (palette.empty()) {
+            palette = { Color::BLUE, Color::CYAN, Color::GREEN, Color::YELLOW, Color::ORANGE, Color::RED };
+        }
+    }
+
+    /**
+     * @brief Appends one time slice (for example ConcurrentHistogram::TakeInterval() every second),
+     * scrolling the oldest slice out once the heatmap is full.
+     * @param Slice The samples of the slice.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void HistogramHeatmap::AddSlice(const LogLinearHistogram& Slice) {
+        std::size_t capacity = static_cast<std::size_t>(columns) * 2;
+        float* slot = shares.data() + next * static_cast<std::size_t>(bands);
+        std::fill(slot, slot + bands, 0.0f);
+
+        if (Slice.Count() > 0) {
+            double total = static_cast<double>(Slice.Count());
+            int last = LogLinearHistogram::BucketIndex(Slice.Max());
+            for (int b = LogLinearHistogram::BucketIndex(Slice.Min()); b <= last; b++) {
+                std::uint64_t count = Slice.BucketValue(b);
+                if (count == 0) {
+                    continue;
+                }
+                double middle = 0.5 * (static_cast<double>(LogLinearHistogram::BucketLowerBound(b))
+                    + static_cast<double>(LogLinearHistogram::BucketUpperBound(b) - 1));
+                int band = static_cast<int>((std::log(std::max(middle, 1.0)) - logMin) * bandsPerLog);
+                slot[std::clamp(band, 0, bands - 1)] += static_cast<float>(static_cast<double>(count) / total);
+            }
+        }
+
+        next = (next + 1) % capacity;
+        slices = std::min(slices + 1, capacity);
+    }
+
+    /**
+     * @brief Removes every slice.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void HistogramHeatmap::Clear() {
+        std::fill(shares.begin(), shares.end(), 0.0f);
+        next = 0;
+        slices = 0;
+    }
+
+    /**
+     * @brief Draws the heatmap, newest slice on the right, with MaxValue labelled on the top line and
+     * MinValue on the bottom one.
+     * @param LabelColor Color code for the labels.
+     * @param Labels How to format the labels.
+     * @return Rows lines separated by '\n' (no trailing newline).
+     */
+    CONSOLETOOLS_INLINE std::string HistogramHeatmap::Render(std::string_view LabelColor, HistogramLabels Labels) const {
+        // Braille dot bits, by dot column and dot row (top to bottom).
+        static constexpr unsigned char DotBits[2][4] = { { 0x01, 0x02, 0x04, 0x40 }, { 0x08, 0x10, 0x20, 0x80 } };
+
+        std::size_t capacity = static_cast<std::size_t>(columns) * 2;
+        std::size_t oldest = (slices == capacity) ? next : 0;
+        std::size_t empty = capacity - slices;
+        int levels = static_cast<int>(palette.size());
+
+        std::string map;
+        for (int row = 0; row < rows; row++) {
+            if (row > 0) {
+                map.push_back('\n');
+            }
+            map.append(LabelColor);
+            if (row == 0) {
+                detail::AppendHistogramLabel(map, maxValue, Labels);
+            }
+            else if (row == rows - 1) {
+                detail::AppendHistogramLabel(map, minValue, Labels);
+            }
+            else {
+                map.append(static_cast<std::size_t>(detail::HistogramLabelWidth), ' ');
+            }
+            map.push_back(' ');
+
+            std::string_view currentColor = LabelColor;
+            for (int column = 0; column < columns; column++) {
+                unsigned int bits = 0;
+                float peak = 0.0f;
+                for (int dx = 0; dx < 2; dx++) {
+                    std::size_t x = static_cast<std::size_t>(column) * 2 + static_cast<std::size_t>(dx);
+                    if (x < empty) {
+                        continue;
+                    }
+                    const float* slot = shares.data() + ((oldest + x - empty) % capacity) * static_cast<std::size_t>(bands);
+                    for (int dy = 0; dy < 4; dy++) {
+                        float share = slot[bands - 1 - (row * 4 + dy)];
+                        if (share > 0.0f) {
+                            bits |= DotBits[dx][dy];
+                            peak = std::max(peak, share);
+                        }
+                    }
+                }
+
+                if (bits == 0) {
+                    map.push_back(' ');
+                    continue;
+                }
+                // The square root spreads out the small shares, which are the interesting ones.
+                int level = std::min(levels - 1, static_cast<int>(std::sqrt(peak) * static_cast<float>(levels)));
+                std::string_view color = palette[static_cast<std::size_t>(level)];
+                if (color != currentColor) {
+                    map.append(color);
+                    currentColor = color;
+                }
+                map.push_back(static_cast<char>(0xE2));
+                map.push_back(static_cast<char>(0xA0 | (bits >> 6)));
+                map.push_back(static_cast<char>(0x80 | (bits & 0x3F)));
+            }
+            map.append(Color::RESET);
+        }
+        return map;
+    }
+
+    /**
+     * @brief Creates a blank frame. The first Render() draws every cell.
+     * @param Columns Width in cells.
+     * @param Rows Height in cells.
+     */
+    CONSOLETOOLS_INLINE FrameBuffer::FrameBuffer(int Columns, int Rows)
+        : columns(0),
+        rows(0)
+    {
+        styles.emplace_back();
+        styleIds.emplace(std::string(), 0);
+        Resize(Columns, Rows);
+    }
+
+    /**
+     * @brief Changes the size, blanks every cell and makes the next Render() draw the whole frame.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FrameBuffer::Resize(int Columns, int Rows) {
+        columns = std::max(Columns, 0);
+        rows = std::max(Rows, 0);
+        cells.assign(static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows), Cell());
+        shown.assign(cells.size(), Cell());
+        fullRedraw = true;
+        dirtyTop = 0;
+        dirtyBottom = rows;
+    }
+
+    /**
+     * @brief Adds rows [Top, Bottom) to the rows the next Render() compares.
+     */
+    CONSOLETOOLS_INLINE void FrameBuffer::Touch(int Top, int Bottom) {
+        Top = std::max(Top, 0);
+        Bottom = std::min(Bottom, rows);
+        if (Top >= Bottom) {
+            return;
+        }
+        if (dirtyTop >= dirtyBottom) {
+            dirtyTop = Top;
+            dirtyBottom = Bottom;
+            return;
+        }
+        dirtyTop = std::min(dirtyTop, Top);
+        dirtyBottom = std::max(dirtyBottom, Bottom);
+    }
+
+    /**
+     * @brief Blanks every cell.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FrameBuffer::Clear() {
+        std::fill(cells.begin(), cells.end(), Cell());
+        Touch(0, rows);
+    }
+
+    namespace detail {
+        /**
+         * @brief Before a cell is overwritten, blanks the other half of a wide character it belongs to.
+         */
+        template <typename CellVector>
+        void BreakWideCell(CellVector& Cells, int Columns, int Row, int Column) {
+            auto& cell = Cells[static_cast<std::size_t>(Row) * static_cast<std::size_t>(Columns) + static_cast<std::size_t>(Column)];
+            if (cell.Width == 0 && Column > 0) {
+                Cells[static_cast<std::size_t>(Row) * static_cast<std::size_t>(Columns) + static_cast<std::size_t>(Column - 1)] =
+                    typename CellVector::value_type();
+            }
+            else if (cell.Width == 2 && Column + 1 < Columns) {
+                Cells[static_cast<std::size_t>(Row) * static_cast<std::size_t>(Columns) + static_cast<std::size_t>(Column + 1)] =
+                    typename CellVector::value_type();
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Blanks the cells of Region.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void FrameBuffer::Clear(const Rect& Region) {
+        int top = std::max(Region.Row, 0);
+        int bottom = std::min(Region.Row + Region.Height, rows);
+        int left = std::max(Region.Column, 0);
+        int right = std::min(Region.Column + Region.Width, columns);
+        Touch(top, bottom);
+        for (int row = top; row < bottom; row++) {
+            if (left >= right) {
+                break;
+            }
+            detail::BreakWideCell(cells, columns, row, left);
+            detail::BreakWideCell(cells, columns, row, right - 1);
+            std::fill(cells.begin() + row * columns + left, cells.begin() + row * columns + right, Cell());
+        }
+    }
+
+    /**
+     * @brief Returns the id of the style Pen draws with, adding it on first use.
+     */
+    CONSOLETOOLS_INLINE std::uint16_t FrameBuffer::InternStyle(const VirtualTerminal::Cell& Pen) {
+        thread_local std::string key;
+        key.assign(Pen.Foreground);
+        key.append(Pen.Background);
+        if (Pen.Bold) {
+            key.append("\033[1m");
+        }
+        if (Pen.Underline) {
+            key.append("\033[4m");
+        }
+        if (Pen.Inverse) {
+            key.append("\033[7m");
+        }
+
+        auto found = styleIds.find(key);
+        if (found != styleIds.end()) {
+            return found->second;
+        }
+        if (styles.size() > std::numeric_limits<std::uint16_t>::max()) {
+            return 0;
+        }
+        std::uint16_t id = static_cast<std::uint16_t>(styles.size());
+        styles.push_back(key);
+        styleIds.emplace(key, id);
+        return id;
+    }
+
+    /**
+     * @brief Draws Text into Region, the way a terminal would show it with the cursor starting at the
+     * region's top-left corner, but clipped to the region instead of wrapping or scrolling.
+     * SGR colors and attributes are kept (each call starts uncolored); other escape sequences are ignored.
+     * @param Region Where to draw. Parts outside the frame are clipped too.
+     * @param Text The text, for example the output of a builder; '\n' starts the next line of the region.
+     * @return The number of lines of Region the text used.
+     */
+    CONSOLETOOLS_INLINE int FrameBuffer::Write(const Rect& Region, std::string_view Text) {
+        if (Region.Width <= 0 || Region.Height <= 0) {
+            return 0;
+        }
+
+        VirtualTerminal::Cell pen;
+        std::uint16_t style = 0;
+        int line = 0;
+        int column = Region.Column;
+        int right = std::min(Region.Column + Region.Width, columns);
+        std::size_t i = 0;
+
+        while (i < Text.size()) {
+            unsigned char c = static_cast<unsigned char>(Text[i]);
+            if (c == 0x1B) {
+                std::size_t length = detail::EscapeSequenceLength(Text, i);
+                if (length >= 3 && Text[i + 1] == '[' && Text[i + length - 1] == 'm') {
+                    detail::ApplySgr(pen, Text.substr(i + 2, length - 3));
+                    style = InternStyle(pen);
+                }
+                i += length;
+                continue;
+            }
+            if (c == '\n') {
+                if (++line >= Region.Height) {
+                    break;
+                }
+                column = Region.Column;
+                i++;
+                continue;
+            }
+            if (c == '\r') {
+                column = Region.Column;
+                i++;
+                continue;
+            }
+            if (c < 0x20 || c == 0x7F) {
+                i++;
+                continue;
+            }
+
+            std::size_t start = i;
+            int width = detail::CodepointWidth(detail::DecodeUtf8(Text, i));
+            if (width == 0) {
+                continue;
+            }
+
+            int row = Region.Row + line;
+            if (row >= 0 && row < rows && column >= 0 && column + width <= right) {
+                Cell cell;
+                cell.Glyph = 0;
+                cell.Length = static_cast<std::uint8_t>(std::min<std::size_t>(i - start, sizeof(cell.Glyph)));
+                std::memcpy(&cell.Glyph, Text.data() + start, cell.Length);
+                cell.Width = static_cast<std::uint8_t>(width);
+                cell.Style = style;
+
+                detail::BreakWideCell(cells, columns, row, column);
+                if (width == 2) {
+                    detail::BreakWideCell(cells, columns, row, column + 1);
+                }
+                std::size_t index = static_cast<std::size_t>(row) * static_cast<std::size_t>(columns) + static_cast<std::size_t>(column);
+                cells[index] = cell;
+                if (width == 2) {
+                    Cell continuation;
+                    continuation.Glyph = 0;
+                    continuation.Length = 0;
+                    continuation.Width = 0;
+                    continuation.Style = style;
+                    cells[index + 1] = continuation;
+                }
+            }
+            column += width;
+        }
+        int used = std::min(line + 1, Region.Height);
+        Touch(Region.Row, Region.Row + used);
+        return used;
+    }
+
+    /**
+     * @brief Returns the bytes that bring the screen from the previously rendered frame to this one:
+     * cursor moves, style changes and the changed cells only. Rows nothing was written to are skipped.
+     * @return A view of the frame's internal buffer, valid until the next Render(); empty if nothing changed.
+     */
+    CONSOLETOOLS_INLINE std::string_view FrameBuffer::Render() {
+        output.clear();
+        int style = 0;
+        int cursorRow = -1;
+        int cursorColumn = -1;
+        int top = fullRedraw ? 0 : dirtyTop;
+        int bottom = fullRedraw ? rows : dirtyBottom;
+
+        for (int row = top; row < bottom; row++) {
+            for (int column = 0; column < columns; column++) {
+                std::size_t index = static_cast<std::size_t>(row) * static_cast<std::size_t>(columns) + static_cast<std::size_t>(column);
+                const Cell& cell = cells[index];
+                if ((!fullRedraw && cell == shown[index]) || cell.Width == 0) {
+                    continue;
+                }
+
+                if (row != cursorRow || column != cursorColumn) {
+                    char move[32];
+                    int length = std::snprintf(move, sizeof(move), "\033[%d;%dH", row + 1, column + 1);
+                    output.append(move, static_cast<std::size_t>(length));
+                }
+                if (cell.Style != style) {
+                    output.append(Color::RESET);
+                    output.append(styles[cell.Style]);
+                    style = cell.Style;
+                }
+                char glyph[sizeof(cell.Glyph)];
+                std::memcpy(glyph, &cell.Glyph, sizeof(glyph));
+                output.append(glyph, cell.Length);
+                cursorRow = row;
+                cursorColumn = column + cell.Width;
+            }
+        }
+        if (style != 0) {
+            output.append(Color::RESET);
+        }
+
+        if (top < bottom) {
+            std::copy(cells.begin() + static_cast<std::ptrdiff_t>(top) * columns,
+                cells.begin() + static_cast<std::ptrdiff_t>(bottom) * columns,
+                shown.begin() + static_cast<std::ptrdiff_t>(top) * columns);
+        }
+        fullRedraw = false;
+        dirtyTop = 0;
+        dirtyBottom = 0;
+        return output;
+    }
+
+    /**
+     * @brief Returns the characters of one row without styles, for tests and debugging.
+     */
+    CONSOLETOOLS_INLINE std::string FrameBuffer::RowText(int Row) const {
+        std::string text;
+        if (Row < 0 || Row >= rows) {
+            return text;
+        }
+        for (int column = 0; column < columns; column++) {
+            const Cell& cell = cells[static_cast<std::size_t>(Row) * static_cast<std::size_t>(columns) + static_cast<std::size_t>(column)];
+            char glyph[sizeof(cell.Glyph)];
+            std::memcpy(glyph, &cell.Glyph, sizeof(glyph));
+            text.append(glyph, cell.Length);
+        }
+        return text;
+    }
+
+    /**
+     * @brief Creates a layout with only the root region, which covers the whole screen.
+     * @param RootDirection How the root arranges its children.
+     */
+    CONSOLETOOLS_INLINE Layout::Layout(LayoutDirection RootDirection) {
+        Node root;
+        root.Direction = RootDirection;
+        nodes.push_back(std::move(root));
+    }
+
+    /**
+     * @brief Adds a region as the last child of Parent.
+     * @param Parent The region to split.
+     * @param Size How much of Parent the region takes along Parent's direction.
+     * @param Direction How the new region arranges its own children.
+     * @return The new region's id, or -1 if Parent does not exist.
+     */
+    CONSOLETOOLS_INLINE int Layout::Add(int Parent, LayoutSize Size, LayoutDirection Direction) {
+        if (Parent < 0 || Parent >= Regions()) {
+            return -1;
+        }
+        int region = Regions();
+        Node node;
+        node.Parent = Parent;
+        node.Size = Size;
+        node.Direction = Direction;
+        nodes.push_back(std::move(node));
+        nodes[static_cast<std::size_t>(Parent)].Children.push_back(region);
+        dirty = true;
+        return region;
+    }
+
+    /**
+     * @brief Draws a border around Region; its content shrinks by one cell on every side.
+     * @param Region The region.
+     * @param Style The border characters (see Borders).
+     * @param Title Text shown in the top border.
+     * @param BorderColor Color code for the border and title.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Layout::SetBorder(int Region, const BorderStyle& Style, std::string_view Title,
+        std::string_view BorderColor)
+    {
+        if (Region < 0 || Region >= Regions()) {
+            return;
+        }
+        Node& node = nodes[static_cast<std::size_t>(Region)];
+        node.HasBorder = true;
+        node.Border = Style;
+        node.Title.assign(Title);
+        node.BorderColor.assign(BorderColor);
+        dirty = true;
+    }
+
+    /**
+     * @brief Computes the geometry of every region for a screen of the given size, unless it is
+     * already up to date.
+     * @param Columns Screen width (for example GetTerminalWidth()).
+     * @param Rows Screen height.
+     * @return true if the geometry was recomputed (redraw everything), false if nothing changed.
+     */
+    CONSOLETOOLS_INLINE bool Layout::Resize(int Columns, int Rows) {
+        Columns = std::max(Columns, 0);
+        Rows = std::max(Rows, 0);
+        if (!dirty && Columns == columns && Rows == rows) {
+            return false;
+        }
+        columns = Columns;
+        rows = Rows;
+        nodes[ROOT].Bounds = Rect{ 0, 0, columns, rows };
+        Arrange(ROOT);
+        dirty = false;
+        return true;
+    }
+
+    /**
+     * @brief Computes Region's content rectangle from its bounds, then lays out its children in it.
+     */
+    CONSOLETOOLS_INLINE void Layout::Arrange(int Region) {
+        Node& node = nodes[static_cast<std::size_t>(Region)];
+        node.Content = node.Bounds;
+        if (node.HasBorder) {
+            node.Content.Row += 1;
+            node.Content.Column += 1;
+            node.Content.Width = std::max(node.Bounds.Width - 2, 0);
+            node.Content.Height = std::max(node.Bounds.Height - 2, 0);
+        }
+        if (node.Children.empty()) {
+            return;
+        }
+
+        bool horizontal = node.Direction == LayoutDirection::Row;
+        int available = horizontal ? node.Content.Width : node.Content.Height;
+        std::size_t count = node.Children.size();
+
+        // Fixed and percentage sizes first; flexible children share what is left by weight.
+        thread_local std::vector<int> sizes;
+        thread_local std::vector<bool> pending;
+        sizes.assign(count, 0);
+        pending.assign(count, false);
+        int remaining = available;
+        for (std::size_t i = 0; i < count; i++) {
+            const LayoutSize& size = nodes[static_cast<std::size_t>(node.Children[i])].Size;
+            if (size.Type == LayoutSize::Kind::Flex) {
+                pending[i] = true;
+                continue;
+            }
+            int cells = (size.Type == LayoutSize::Kind::Fixed) ? size.Value : available * size.Value / 100;
+            sizes[i] = std::max({ cells, size.Min, 0 });
+            remaining -= sizes[i];
+        }
+        remaining = std::max(remaining, 0);
+
+        // A flexible child whose share is below its minimum gets the minimum and leaves the pool.
+        for (;;) {
+            long long weight = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                if (pending[i]) {
+                    weight += std::max(nodes[static_cast<std::size_t>(node.Children[i])].Size.Value, 0);
+                }
+            }
+            if (weight == 0) {
+                break;
+            }
+
+            bool changed = false;
+            for (std::size_t i = 0; i < count; i++) {
+                const LayoutSize& size = nodes[static_cast<std::size_t>(node.Children[i])].Size;
+                if (pending[i] && remaining * static_cast<long long>(std::max(size.Value, 0)) / weight < size.Min) {
+                    sizes[i] = size.Min;
+                    remaining = std::max(remaining - size.Min, 0);
+                    pending[i] = false;
+                    changed = true;
+                }
+            }
+            if (changed) {
+                continue;
+            }
+
+            // Cumulative rounding hands out every remaining cell.
+            long long seen = 0;
+            int given = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                if (!pending[i]) {
+                    continue;
+                }
+                seen += std::max(nodes[static_cast<std::size_t>(node.Children[i])].Size.Value, 0);
+                int upTo = static_cast<int>(remaining * seen / weight);
+                sizes[i] = upTo - given;
+                given = upTo;
+                pending[i] = false;
+            }
+            break;
+        }
+
+        // Children past the end of the parent are clipped, down to nothing.
+        int offset = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            int size = std::min(sizes[i], std::max(available - offset, 0));
+            Node& child = nodes[static_cast<std::size_t>(node.Children[i])];
+            const Rect& content = nodes[static_cast<std::size_t>(Region)].Content;
+            child.Bounds = horizontal ? Rect{ content.Row, content.Column + offset, size, content.Height }
+                : Rect{ content.Row + offset, content.Column, content.Width, size };
+            offset += size;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            Arrange(nodes[static_cast<std::size_t>(Region)].Children[i]);
+        }
+    }
+
+    /**
+     * @brief Draws the border and title of every bordered region into Frame.
+     * @return void
+     */
+    CONSOLETOOLS_INLINE void Layout::DrawBorders(FrameBuffer& Frame) const {
+        std::string line;
+        for (const Node& node : nodes) {
+            const Rect& box = node.Bounds;
+            if (!node.HasBorder || box.Width < 2 || box.Height < 2) {
+                continue;
+            }
+            const BorderStyle& border = node.Border;
+
+            line.assign(node.BorderColor);
+            line.append(border.TopLeft);
+            detail::AppendRepeated(line, border.Horizontal, box.Width - 2);
+            line.append(border.TopRight);
+            Frame.Write(Rect{ box.Row, box.Column, box.Width, 1 }, line);
+
+            if (!node.Title.empty() && box.Width > 4) {
+                line.assign(node.BorderColor);
+                line.push_back(' ');
+                line.append(node.Title);
+                line.push_back(' ');
+                Frame.Write(Rect{ box.Row, box.Column + 2, box.Width - 4, 1 }, line);
+            }
+
+            line.assign(node.BorderColor);
+            line.append(border.BottomLeft);
+            detail::AppendRepeated(line, border.Horizontal, box.Width - 2);
+            line.append(border.BottomRight);
+            Frame.Write(Rect{ box.Row + box.Height - 1, box.Column, box.Width, 1 }, line);
+
+            line.assign(node.BorderColor);
+            line.append(border.Vertical);
+            for (int row = box.Row + 1; row < box.Row + box.Height - 1; row++) {
+                Frame.Write(Rect{ row, box.Column, 1, 1 }, line);
+                Frame.Write(Rect{ row, box.Column + box.Width - 1, 1, 1 }, line);
+            }
+        }
+    }
+
+    /**
+     * @brief Draws a widget's output into the content area of Region (see FrameBuffer::Write()).
+     * @return The number of lines used.
+     */
+    CONSOLETOOLS_INLINE int Layout::Draw(FrameBuffer& Frame, int Region, std::string_view Text) const {
+        if (Region < 0 || Region >= Regions()) {
+            return 0;
+        }
+        return Frame.Write(Content(Region), Text);
+    }
+
+    namespace detail {
+        /**
+         * @struct WrapToken
+         * @brief One word of the paragraph being wrapped: its bytes (escape sequences included), its
+         * width, and the width of the blanks before it, which are dropped when the word starts a line.
+         * PlainGap means those blanks are GapWidth spaces in the text, so the word can be copied
+         * together with the one before it.
+         */
+        struct WrapToken {
+            std::size_t Begin;
+            std::size_t End;
+            int Width;
+            int GapWidth;
+            bool HasEscape;
+            bool PlainGap;
+        };
+
+        /**
+         * @brief Splits the paragraph starting at Index into words and advances Index to its end
+         * (the '\n' or the end of Text). Words wider than MaxWidth are cut into MaxWidth pieces.
+         */
+        inline void TokenizeParagraph(std::string_view Text, std::size_t& Index, int MaxWidth, std::vector<WrapToken>& Tokens) {
+            Tokens.clear();
+            WrapToken word{ std::string_view::npos, 0, 0, 0, false, true };
+            int gapWidth = 0;
+            bool plainGap = true;
+
+            auto endWord = [&](std::size_t End) {
+                if (word.Begin == std::string_view::npos) {
+                    return;
+                }
+                word.End = End;
+                word.GapWidth = gapWidth;
+                word.PlainGap = plainGap;
+                Tokens.push_back(word);
+                word = WrapToken{ std::string_view::npos, 0, 0, 0, false, true };
+                gapWidth = 0;
+                plainGap = true;
+            };
+
+            std::size_t i = Index;
+            while (i < Text.size() && Text[i] != '\n') {
+                unsigned char c = static_cast<unsigned char>(Text[i]);
+                if (c == 0x1B) {
+                    if (word.Begin == std::string_view::npos) {
+                        word.Begin = i;
+                    }
+                    word.HasEscape = true;
+                    i += EscapeSequenceLength(Text, i);
+                    continue;
+                }
+                if (c <= 0x20 || c == 0x7F) {
+                    // Spaces, tabs and stray control characters all separate words.
+                    endWord(i);
+                    gapWidth++;
+                    plainGap = plainGap && c == ' ';
+                    i++;
+                    continue;
+                }
+
+                if (c < 0x80) {
+                    // Runs of printable ASCII, one column per byte, are the common case.
+                    if (word.Begin == std::string_view::npos) {
+                        word.Begin = i;
+                    }
+                    do {
+                        if (word.Width >= MaxWidth) {
+                            endWord(i);
+                            word.Begin = i;
+                        }
+                        word.Width++;
+                        i++;
+                    } while (i < Text.size() && static_cast<unsigned char>(Text[i]) > 0x20 && static_cast<unsigned char>(Text[i]) < 0x7F);
+                    continue;
+                }
+
+                std::size_t start = i;
+                int width = CodepointWidth(DecodeUtf8(Text, i));
+                if (word.Begin == std::string_view::npos) {
+                    word.Begin = start;
+                }
+                else if (word.Width > 0 && word.Width + width > MaxWidth) {
+                    endWord(start);
+                    word.Begin = start;
+                }
+                word.Width += width;
+            }
+            endWord(i);
+            Index = i;
+        }
+
+        /**
+         * @brief Marks in Breaks which tokens start a new line. FirstWidth applies to the paragraph's
+         * first line, Width to the others.
+         */
+        inline void ChooseBreaks(const std::vector<WrapToken>& Tokens, int FirstWidth, int Width, WrapMode Mode,
+            std::vector<char>& Breaks)
+        {
+            std::size_t count = Tokens.size();
+            Breaks.assign(count, 0);
+            if (count == 0) {
+                return;
+            }
+
+            if (Mode == WrapMode::Greedy) {
+                int used = Tokens[0].Width;
+                int limit = FirstWidth;
+                Breaks[0] = 1;
+                for (std::size_t k = 1; k < count; k++) {
+                    if (used + Tokens[k].GapWidth + Tokens[k].Width <= limit) {
+                        used += Tokens[k].GapWidth + Tokens[k].Width;
+                        continue;
+                    }
+                    Breaks[k] = 1;
+                    used = Tokens[k].Width;
+                    limit = Width;
+                }
+                return;
+            }
+
+            // Minimum raggedness: Cost[j] is the least sum of squared slack over the lines holding
+            // tokens [0, j), the last line of the paragraph being free. Lines are tried from their
+            // end backwards until they overflow, so this is linear in the number of words per line.
+            thread_local std::vector<long long> cost;
+            thread_local std::vector<std::size_t> from;
+            cost.assign(count + 1, std::numeric_limits<long long>::max());
+            from.assign(count + 1, 0);
+            cost[0] = 0;
+            int widest = std::max(FirstWidth, Width);
+
+            for (std::size_t j = 1; j <= count; j++) {
+                int lineWidth = 0;
+                for (std::size_t i = j; i-- > 0;) {
+                    lineWidth += Tokens[i].Width + ((i + 1 < j) ? Tokens[i + 1].GapWidth : 0);
+                    if (lineWidth > widest && i + 1 < j) {
+                        break;
+                    }
+                    int limit = (i == 0) ? FirstWidth : Width;
+                    if ((lineWidth > limit && i + 1 < j) || cost[i] == std::numeric_limits<long long>::max()) {
+                        continue;
+                    }
+                    long long slack = std::max(limit - lineWidth, 0);
+                    long long total = cost[i] + ((j == count) ? 0 : slack * slack);
+                    if (total < cost[j]) {
+                        cost[j] = total;
+                        from[j] = i;
+                    }
+                }
+            }
+            for (std::size_t j = count; j > 0; j = from[j]) {
+                Breaks[from[j]] = 1;
+            }
+        }
+
+        /**
+         * @brief Updates Style, the SGR sequences in effect, with those in Word.
+         */
+        inline void TrackStyle(std::string& Style, std::string_view Word) {
+            for (std::size_t i = Word.find('\033'); i != std::string_view::npos; i = Word.find('\033', i)) {
+                std::size_t length = EscapeSequenceLength(Word, i);
+                if (length >= 3 && Word[i + 1] == '[' && Word[i + length - 1] == 'm') {
+                    std::string_view parameters = Word.substr(i + 2, length - 3);
+                    if (parameters.empty() || parameters == "0" || parameters.substr(0, 2) == "0;") {
+                        Style.clear();
+                    }
+                    if (!parameters.empty() && parameters != "0") {
+                        Style.append(Word.substr(i, length));
+                    }
+                }
+                i += length;
+            }
+        }
+
+        /**
+         * @brief Appends Text wrapped to FirstWidth columns on its first line and Width columns on the
+         * others, which are indented by Indent spaces. Existing '\n' are kept. Colors in effect at a
+         * break are reset before it and restored after the indent.
+         * @param BaseStyle The color Text starts in (already emitted by the caller).
+         */
+        template <typename String>
+        void AppendWrapped(String& Out, std::string_view Text, int FirstWidth, int Width, int Indent,
+            WrapMode Mode, std::string_view BaseStyle = {})
+        {
+            FirstWidth = std::max(FirstWidth, 1);
+            Width = std::max(Width, 1);
+            Indent = std::max(Indent, 0);
+
+            thread_local std::vector<WrapToken> tokens;
+            thread_local std::vector<char> breaks;
+            thread_local std::string style;
+            style.assign(BaseStyle);
+            Out.reserve(Out.size() + Text.size() + Text.size() / static_cast<std::size_t>(Width) * (Indent + 1));
+
+            bool firstLine = true;
+            bool pendingIndent = false;
+            auto newLine = [&]() {
+                if (!style.empty()) {
+                    Out.append(Color::RESET);
+                }
+                Out.push_back('\n');
+                firstLine = false;
+                pendingIndent = true;
+            };
+
+            std::size_t i = 0;
+            while (i <= Text.size()) {
+                TokenizeParagraph(Text, i, std::min(FirstWidth, Width), tokens);
+                ChooseBreaks(tokens, firstLine ? FirstWidth : Width, Width, Mode, breaks);
+
+                std::size_t count = tokens.size();
+                for (std::size_t k = 0; k < count;) {
+                    if (breaks[k] && k > 0) {
+                        newLine();
+                    }
+                    if (pendingIndent) {
+                        Out.append(static_cast<std::size_t>(Indent), ' ');
+                        Out.append(style);
+                        pendingIndent = false;
+                    }
+                    if (!breaks[k]) {
+                        Out.append(static_cast<std::size_t>(tokens[k].GapWidth), ' ');
+                    }
+
+                    // Words on the same line separated by plain spaces are copied in one go.
+                    std::size_t last = k;
+                    bool hasEscape = tokens[k].HasEscape;
+                    while (last + 1 < count && !breaks[last + 1] && tokens[last + 1].PlainGap) {
+                        last++;
+                        hasEscape = hasEscape || tokens[last].HasEscape;
+                    }
+                    std::string_view words = Text.substr(tokens[k].Begin, tokens[last].End - tokens[k].Begin);
+                    Out.append(words);
+                    if (hasEscape) {
+                        TrackStyle(style, words);
+                    }
+                    k = last + 1;
+                }
+
+                if (i >= Text.size()) {
+                    break;
+                }
+                newLine();
+                i++;
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Wraps Text at word boundaries so no line is wider than Width columns. Color codes take no
+     * room and wide characters take two columns; words longer than a line are cut.
+     * @param Text The text. Existing line breaks are kept; runs of blanks at a break are dropped.
+     * @param Width Columns per line, including the indent, or FILL_AVAILABLE_WIDTH for the terminal width.
+     * @param HangingIndent Spaces before every line but the first, to line continuations up under a label.
+     * @param Mode Greedy, or Balanced for lines of more even length.
+     * @return The wrapped text.
+     */
+    CONSOLETOOLS_INLINE std::string WrapText(std::string_view Text, int Width, int HangingIndent, WrapMode Mode) {
+        if (Width == FILL_AVAILABLE_WIDTH) {
+            Width = detail::AvailableColumns();
+        }
+        HangingIndent = std::clamp(HangingIndent, 0, std::max(Width - 1, 0));
+        std::string wrapped;
+        detail::AppendWrapped(wrapped, Text, Width, Width - HangingIndent, HangingIndent, Mode);
+        return wrapped;
+    }
+
+    /**
+     * @brief WrapText() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view WrapTextView(std::string_view Text, int Width, int HangingIndent, WrapMode Mode) {
+        if (Width == FILL_AVAILABLE_WIDTH) {
+            Width = detail::AvailableColumns();
+        }
+        HangingIndent = std::clamp(HangingIndent, 0, std::max(Width - 1, 0));
+        std::string& wrapped = detail::ViewBuffer();
+        detail::AppendWrapped(wrapped, Text, Width, Width - HangingIndent, HangingIndent, Mode);
+        return wrapped;
+    }
+
+    /**
+     * @brief Notification() with its text wrapped to Width columns, continuation lines starting under
+     * the first word of the text rather than under the border.
+     * @param Width Total width of the notification, or FILL_AVAILABLE_WIDTH for the terminal width.
+     * @param Mode Greedy, or Balanced for lines of more even length.
+     * @return A formatted notification string; every line but the last ends in '\n'.
+     */
+    CONSOLETOOLS_INLINE std::string WrappedNotification(std::string_view LeftBorderCharacter,
+        std::string_view InsideCharacter,
+        std::string_view RightBorderCharacter,
+        std::string_view NotificationTypeText,
+        std::string_view NotificationText,
+        std::string_view BorderCharacterColor,
+        std::string_view InsideCharacterColor,
+        std::string_view NotificationTextColor,
+        int Width,
+        WrapMode Mode)
+    {
+        if (Width == FILL_AVAILABLE_WIDTH) {
+            Width = detail::AvailableColumns();
+        }
+        int indent = VisibleWidth(LeftBorderCharacter) + VisibleWidth(InsideCharacter) + VisibleWidth(RightBorderCharacter)
+            + 1 + VisibleWidth(NotificationTypeText) + 2;
+
+        std::string notification;
+        CONSOLETOOLS_MEASURE_APPEND(Metric::Notification, notification);
+        detail::AppendNotificationPrefix(notification, LeftBorderCharacter, InsideCharacter, RightBorderCharacter,
+            NotificationTypeText, BorderCharacterColor, InsideCharacterColor);
+        notification.append(NotificationTextColor);
+        detail::AppendWrapped(notification, NotificationText, Width - indent, Width - indent, indent, Mode,
+            NotificationTextColor);
+        notification.append(Color::RESET);
+        return notification;
+    }
+
+    namespace detail {
+        /**
+         * @brief Switches from style Current to Next, emitting codes only if they differ.
+         */
+        template <typename String>
+        void AppendStyleSwitch(String& Out, MarkupStyle& Current, const MarkupStyle& Next) {
+            if (Next == Current) {
+                return;
+            }
+            if (Current != MarkupStyle()) {
+                Out.append(Color::RESET);
+            }
+            Out.append(MarkupColors[Next.Color].Code);
+            if (Next.Bold) {
+                Out.append("\033[1m");
+            }
+            if (Next.Underline) {
+                Out.append("\033[4m");
+            }
+            Current = Next;
+        }
+
+        /**
+         * @brief Pads the field that starts at Start in Out to Spec.Width columns. Numbers align right
+         * by default and zero padding goes after the sign.
+         */
+        template <typename String>
+        void PadField(String& Out, std::size_t Start, const FormatSpec& Spec, bool Numeric) {
+            if (Spec.Width <= 0) {
+                return;
+            }
+            int padding = Spec.Width - VisibleWidth(std::string_view(Out.data() + Start, Out.size() - Start));
+            if (padding <= 0) {
+                return;
+            }
+            if (Spec.ZeroPad && Spec.Align == 0) {
+                std::size_t digits = Start + ((Out.size() > Start && Out[Start] == '-') ? 1 : 0);
+                Out.insert(digits, static_cast<std::size_t>(padding), '0');
+                return;
+            }
+            char align = Spec.Align != 0 ? Spec.Align : (Numeric ? '>' : '<');
+            int before = (align == '>') ? padding : (align == '^') ? padding / 2 : 0;
+            Out.insert(Start, static_cast<std::size_t>(before), Spec.Fill);
+            Out.append(static_cast<std::size_t>(padding - before), Spec.Fill);
+        }
+
+        /**
+         * @brief Appends compiled markup, switching styles only where they change.
+         */
+        template <typename String>
+        void AppendMarkupRuns(String& Out, std::string_view Text, const MarkupRun* Runs, std::size_t Count,
+            std::initializer_list<std::string_view> Arguments)
+        {
+            std::size_t reserve = Text.size();
+            for (std::string_view argument : Arguments) {
+                reserve += argument.size();
+            }
+            Out.reserve(Out.size() + reserve + Count * 8);
+
+            MarkupStyle current;
+            for (std::size_t i = 0; i < Count; i++) {
+                const MarkupRun& run = Runs[i];
+                if (run.Argument < 0) {
+                    if (run.Length > 0) {
+                        AppendStyleSwitch(Out, current, run.Style);
+                        Out.append(Text.substr(run.Begin, run.Length));
+                    }
+                    continue;
+                }
+
+                std::string_view piece;
+                if (static_cast<std::size_t>(run.Argument) < Arguments.size()) {
+                    piece = Arguments.begin()[run.Argument];
+                }
+                FormatSpec spec;
+                ParseFormatSpec(Text.substr(run.Begin, run.Length), spec);
+                if (piece.empty() && spec.Width <= 0) {
+                    continue;
+                }
+                AppendStyleSwitch(Out, current, run.Style);
+                std::size_t start = Out.size();
+                Out.append(piece);
+                PadField(Out, start, spec, false);
+            }
+            if (current != MarkupStyle()) {
+                Out.append(Color::RESET);
+            }
+        }
+
+        /**
+         * @brief Renders compiled markup runs with Arguments substituted; missing arguments render empty.
+         */
+        CONSOLETOOLS_INLINE std::string RenderMarkupRuns(std::string_view Text, const MarkupRun* Runs, std::size_t Count,
+            std::initializer_list<std::string_view> Arguments)
+        {
+            std::string rendered;
+            AppendMarkupRuns(rendered, Text, Runs, Count, Arguments);
+            return rendered;
+        }
+
+        /**
+         * @brief RenderMarkupRuns() into this thread's view buffer.
+         */
+        CONSOLETOOLS_INLINE std::string_view RenderMarkupRunsView(std::string_view Text, const MarkupRun* Runs, std::size_t Count,
+            std::initializer_list<std::string_view> Arguments)
+        {
+            std::string& rendered = ViewBuffer();
+            AppendMarkupRuns(rendered, Text, Runs, Count, Arguments);
+            return rendered;
+        }
+
+        /**
+         * @brief Returns Template compiled, from this thread's parse cache. The cache holds up to 256
+         * templates and starts over when full; a hash collision recompiles, never renders the wrong template.
+         */
+        inline const Markup& CachedMarkup(std::string_view Template) {
+            constexpr std::size_t CAPACITY = 256;
+            thread_local std::unordered_map<std::uint64_t, Markup> cache;
+
+            std::uint64_t hash = Fnv1a(Template);
+            auto found = cache.find(hash);
+            if (found != cache.end() && found->second.Template() == Template) {
+                return found->second;
+            }
+            if (found == cache.end() && cache.size() >= CAPACITY) {
+                cache.clear();
+            }
+            return cache.insert_or_assign(hash, Markup(Template)).first->second;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Compiles a markup template into style runs.
+     * @param Template The markup; it is copied, so it need not outlive the Markup.
+     */
+    CONSOLETOOLS_INLINE Markup::Markup(std::string_view Template)
+        : text(Template),
+        arguments(0)
+    {
+        arguments = detail::ParseMarkup(text, [this](const MarkupRun& Run) { runs.push_back(Run); });
+    }
+
+    /**
+     * @brief Renders a markup template (see Markup), compiling it on first use and reusing the compiled
+     * runs afterwards, so a template used for many messages is parsed once per thread.
+     * @param Template The markup, e.g. "[bold red]{}[/] failed after {} retries".
+     * @param Arguments Values for the template's placeholders, inserted as plain text.
+     * @return The text with color codes.
+     */
+    CONSOLETOOLS_INLINE std::string RenderMarkup(std::string_view Template, std::initializer_list<std::string_view> Arguments) {
+        return detail::CachedMarkup(Template).Render(Arguments);
+    }
+
+    /**
+     * @brief RenderMarkup() rendered into this thread's view buffer. Neither Template nor the arguments
+     * may be another *View result.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view RenderMarkupView(std::string_view Template, std::initializer_list<std::string_view> Arguments) {
+        return detail::CachedMarkup(Template).RenderView(Arguments);
+    }
+
+    namespace detail {
+        /**
+         * @brief Reports a malformed format string. Reached during constant evaluation it stops the
+         * compilation; at run time (C++17) it throws std::invalid_argument.
+         */
+        CONSOLETOOLS_INLINE void FormatError(const char* Message) {
+            throw std::invalid_argument(std::string("ConsoleTools format string: ") + Message);
+        }
+
+        /**
+         * @brief Appends an integer in the base Spec.Type asks for (decimal by default), or as a character for 'c'.
+         */
+        template <typename Integer>
+        void AppendInteger(std::string& Out, Integer Value, const FormatSpec& Spec) {
+            if (Spec.Type == 'c') {
+                Out.push_back(static_cast<char>(Value));
+                return;
+            }
+            int base = (Spec.Type == 'x' || Spec.Type == 'X') ? 16 : (Spec.Type == 'o') ? 8 : 10;
+            char digits[72];
+            std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), Value, base);
+            if (Spec.Type == 'X') {
+                for (char* c = digits; c != result.ptr; c++) {
+                    *c = static_cast<char>(std::toupper(static_cast<unsigned char>(*c)));
+                }
+            }
+            Out.append(digits, static_cast<std::size_t>(result.ptr - digits));
+        }
+
+        CONSOLETOOLS_INLINE void AppendFormattedInteger(std::string& Out, std::int64_t Value, const FormatSpec& Spec) {
+            AppendInteger(Out, Value, Spec);
+        }
+
+        CONSOLETOOLS_INLINE void AppendFormattedInteger(std::string& Out, std::uint64_t Value, const FormatSpec& Spec) {
+            AppendInteger(Out, Value, Spec);
+        }
+
+        /**
+         * @brief Appends a floating-point value: the shortest text that reads back exactly by default,
+         * otherwise fixed ('f', 6 decimals unless a precision is given), scientific ('e') or general ('g').
+         */
+        CONSOLETOOLS_INLINE void AppendFormattedFloat(std::string& Out, double Value, const FormatSpec& Spec) {
+            char digits[384];
+            int precision = Spec.Precision;
+            char type = Spec.Type;
+            if (type == 0 && precision >= 0) {
+                type = 'g';
+            }
+            if (type != 0 && precision < 0) {
+                precision = 6;
+            }
+#if defined(__cpp_lib_to_chars)
+            std::to_chars_result result = (type == 0) ? std::to_chars(digits, digits + sizeof(digits), Value)
+                : std::to_chars(digits, digits + sizeof(digits), Value,
+                    (type == 'f') ? std::chars_format::fixed : (type == 'e') ? std::chars_format::scientific : std::chars_format::general,
+                    precision);
+            Out.append(digits, static_cast<std::size_t>(result.ptr - digits));
+#else
+            int length = (type == 0) ? std::snprintf(digits, sizeof(digits), "%.17g", Value)
+                : std::snprintf(digits, sizeof(digits), (type == 'f') ? "%.*f" : (type == 'e') ? "%.*e" : "%.*g", precision, Value);
+            Out.append(digits, static_cast<std::size_t>(std::clamp(length, 0, static_cast<int>(sizeof(digits)) - 1)));
+#endif
+        }
+
+        /**
+         * @brief Formats a checked format string with type-erased arguments, appending to Out. The
+         * compiled runs are walked as they are; only a string too long to compile is parsed here.
+         */
+        CONSOLETOOLS_INLINE void VFormatTo(std::string& Out, const CompiledFormat& Format, const FormatArgument* Arguments, std::size_t Count) {
+            std::string_view text = Format.Text;
+            Out.reserve(Out.size() + text.size() + Count * 8);
+            MarkupStyle current;
+            auto append = [&](const MarkupRun& Run, const FormatSpec& Spec) {
+                if (Run.Argument < 0) {
+                    AppendStyleSwitch(Out, current, Run.Style);
+                    Out.append(text.substr(Run.Begin, Run.Length));
+                    return;
+                }
+                if (static_cast<std::size_t>(Run.Argument) >= Count) {
+                    return;
+                }
+                const FormatArgument& argument = Arguments[Run.Argument];
+                AppendStyleSwitch(Out, current, Run.Style);
+                std::size_t start = Out.size();
+                argument.Append(Out, argument.Value, Spec);
+                PadField(Out, start, Spec, argument.Kind == 'i' || argument.Kind == 'f');
+            };
+            if (Format.Runs != nullptr) {
+                for (std::size_t i = 0; i < Format.Count; i++) {
+                    append(Format.Runs[i].Run, Format.Runs[i].Spec);
+                }
+            }
+            else {
+                ParseMarkup(text, [&](const MarkupRun& Run) {
+                    FormatSpec spec;
+                    if (Run.Argument >= 0) {
+                        ParseFormatSpec(text.substr(Run.Begin, Run.Length), spec);
+                    }
+                    append(Run, spec);
+                });
+            }
+            if (current != MarkupStyle()) {
+                Out.append(Color::RESET);
+            }
+        }
+
+        /**
+         * @brief VFormatTo() into this thread's view buffer.
+         */
+        CONSOLETOOLS_INLINE std::string_view VFormatView(const CompiledFormat& Format, const FormatArgument* Arguments, std::size_t Count) {
+            std::string& formatted = ViewBuffer();
+            VFormatTo(formatted, Format, Arguments, Count);
+            return formatted;
+        }
+
+        /**
+         * @brief VFormatTo() into a per-thread buffer, then written to the output sink.
+         */
+        CONSOLETOOLS_INLINE void VPrintFormat(const CompiledFormat& Format, const FormatArgument* Arguments, std::size_t Count) {
+            thread_local std::string buffer;
+            buffer.clear();
+            VFormatTo(buffer, Format, Arguments, Count);
+            Print(buffer);
+        }
+    } // namespace detail
+
+    namespace detail {
+        /**
+         * @brief Renders a batch of advanced progress bars, one row per bar, rows separated by '\n'.
+         * Each row is byte-for-byte what AdvancedProgressBar() returns for the same values.
+         */
+        template <typename String>
+        void AppendAdvancedProgressBars(String& Out,
+            const ProgressBarStyle& Style,
+            const int* CurrentPercentages,
+            const int* MaxPercentages,
+            const std::string_view* Labels,
+            std::size_t Count)
+        {
+            thread_local std::vector<int> widths;
+            thread_local std::vector<int> filled;
+            thread_local std::vector<int> percentages;
+            thread_local std::string fillRun;
+            thread_local std::string unfilledRun;
+            widths.resize(Count);
+            filled.resize(Count);
+            percentages.resize(Count);
+
+            if (Style.BarWidth == FILL_AVAILABLE_WIDTH) {
+                for (std::size_t i = 0; i < Count; i++) {
+                    widths[i] = ResolveBarWidth(Style.BarWidth, Labels ? Labels[i] : std::string_view(), Style.SuffixText,
+                        Style.FillChar, Style.UnfilledChar, Style.ShowPercentage, Style.ShowBrackets);
+                }
+            }
+            else {
+                std::fill(widths.begin(), widths.end(), Style.BarWidth);
+            }
+
+            // Same arithmetic as AdvancedProgressBar(), written without branches so it vectorizes.
+            const int* width = widths.data();
+            int* fill = filled.data();
+            int* percentage = percentages.data();
+            for (std::size_t i = 0; i < Count; i++) {
+                int maximum = MaxPercentages[i];
+                int current = std::min(std::max(CurrentPercentages[i], 0), maximum);
+                double divisor = (maximum != 0) ? maximum : 1;
+                double progress = (maximum != 0) ? current / divisor : 0.0;
+                fill[i] = static_cast<int>(progress * width[i]);
+                percentage[i] = static_cast<int>(progress * 100);
+            }
+
+            // The fill and unfill characters are laid out once; each row copies a prefix of them.
+            int widest = 0;
+            for (std::size_t i = 0; i < Count; i++) {
+                widest = std::max(widest, width[i]);
+            }
+            fillRun.clear();
+            unfilledRun.clear();
+            AppendRepeated(fillRun, Style.FillChar, widest);
+            AppendRepeated(unfilledRun, Style.UnfilledChar, widest);
+
+            std::size_t fixedBytes = Style.PrefixColor.size() + Style.BracketColor.size() * 2 + 2 + Style.FillColor.size()
+                + Style.UnfilledColor.size() + Style.TextColor.size() + 16 + Style.SuffixColor.size() + Style.SuffixText.size()
+                + 2 + std::strlen(Color::RESET);
+            std::size_t unitBytes = std::max(Style.FillChar.size(), Style.UnfilledChar.size());
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < Count; i++) {
+                total += fixedBytes + static_cast<std::size_t>(std::max(width[i], 0)) * unitBytes + (Labels ? Labels[i].size() : 0);
+            }
+
+            // Rows are copied into one buffer sized for all of them up front, then trimmed.
+            std::size_t start = Out.size();
+            Out.resize(start + total);
+            char* cursor = &Out[0] + start;
+            auto put = [&cursor](const char* Data, std::size_t Size) {
+                // Empty style fields are default string_views, whose data() is null.
+                if (Size > 0) {
+                    std::memcpy(cursor, Data, Size);
+                    cursor += Size;
+                }
+            };
+            auto putView = [&put](std::string_view Text) { put(Text.data(), Text.size()); };
+
+            for (std::size_t i = 0; i < Count; i++) {
+                if (i > 0) {
+                    *cursor++ = '\n';
+                }
+                std::string_view label = Labels ? Labels[i] : std::string_view();
+                if (!label.empty()) {
+                    putView(Style.PrefixColor);
+                    putView(label);
+                }
+                if (Style.ShowBrackets) {
+                    putView(Style.BracketColor);
+                    *cursor++ = '[';
+                }
+                int filledWidth = std::max(fill[i], 0);
+                int remainingWidth = std::max(width[i] - fill[i], 0);
+                putView(Style.FillColor);
+                put(fillRun.data(), static_cast<std::size_t>(filledWidth) * Style.FillChar.size());
+                putView(Style.UnfilledColor);
+                put(unfilledRun.data(), static_cast<std::size_t>(remainingWidth) * Style.UnfilledChar.size());
+                if (Style.ShowBrackets) {
+                    putView(Style.BracketColor);
+                    *cursor++ = ']';
+                }
+                if (Style.ShowPercentage) {
+                    putView(Style.TextColor);
+                    *cursor++ = ' ';
+                    cursor = std::to_chars(cursor, cursor + 12, percentage[i]).ptr;
+                    *cursor++ = '%';
+                }
+                if (!Style.SuffixText.empty()) {
+                    *cursor++ = ' ';
+                    putView(Style.SuffixColor);
+                    putView(Style.SuffixText);
+                }
+                if (Style.ResetColorOnCompletion) {
+                    putView(Color::RESET);
+                }
+            }
+            Out.resize(static_cast<std::size_t>(cursor - Out.data()));
+        }
+    } // namespace detail
+
+    /**
+     * @brief Renders many advanced progress bars that share one style in a single call, one row per bar.
+     * Much cheaper than calling AdvancedProgressBar() per row: the style is read once, the fill widths
+     * of all bars are computed in one loop and every row is written into one buffer.
+     * @param Style The shared parameters; Labels take the place of PrefixText.
+     * @param CurrentPercentages Current value of each bar.
+     * @param MaxPercentages Maximum value of each bar.
+     * @param Labels Prefix text of each bar, or nullptr for none.
+     * @param Count The number of bars.
+     * @return The rows, separated by '\n'; each is identical to AdvancedProgressBar()'s output.
+     */
+    CONSOLETOOLS_INLINE std::string AdvancedProgressBars(const ProgressBarStyle& Style,
+        const int* CurrentPercentages,
+        const int* MaxPercentages,
+        const std::string_view* Labels,
+        std::size_t Count)
+    {
+        std::string bars;
+        detail::AppendAdvancedProgressBars(bars, Style, CurrentPercentages, MaxPercentages, Labels, Count);
+        return bars;
+    }
+
+    /**
+     * @brief AdvancedProgressBars() rendered into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view AdvancedProgressBarsView(const ProgressBarStyle& Style,
+        const int* CurrentPercentages,
+        const int* MaxPercentages,
+        const std::string_view* Labels,
+        std::size_t Count)
+    {
+        std::string& bars = detail::ViewBuffer();
+        detail::AppendAdvancedProgressBars(bars, Style, CurrentPercentages, MaxPercentages, Labels, Count);
+        return bars;
+    }
+
+    // Widgets
+
+    namespace detail {
+        /**
+         * @brief Returns Count repetitions of Unit from the start of Run, first extending Run if it is too short.
+         * Run must only ever hold repetitions of Unit.
+         */
+        inline std::string_view RepeatedRun(std::string& Run, std::string_view Unit, int Count) {
+            std::size_t bytes = static_cast<std::size_t>(std::max(Count, 0)) * Unit.size();
+            while (Run.size() < bytes) {
+                Run.append(Unit);
+            }
+            return std::string_view(Run.data(), bytes);
+        }
+
+        /**
+         * @brief Copies Text to Cursor and returns the position just past it.
+         */
+        inline char* CopyTo(char* Cursor, std::string_view Text) {
+            // An empty string_view may have a null data(), which memcpy does not accept.
+            if (!Text.empty()) {
+                std::memcpy(Cursor, Text.data(), Text.size());
+            }
+            return Cursor + Text.size();
+        }
+    } // namespace detail
+
+    /**
+     * @brief Lays out everything in an AdvancedProgressBar() that does not depend on the progress.
+     * @param Style The bar's style; it is copied.
+     * @param Label Text in front of the bar, in Style.PrefixColor.
+     */
+    CONSOLETOOLS_INLINE ProgressBarWidget::ProgressBarWidget(const ProgressBarStyle& Style, std::string_view Label)
+        : unfilledColor(Style.UnfilledColor),
+        fillChar(Style.FillChar),
+        unfilledChar(Style.UnfilledChar),
+        barWidth(Style.BarWidth),
+        fixedWidth(VisibleWidth(Label)
+            + (Style.ShowBrackets ? 2 : 0)
+            + (Style.ShowPercentage ? 5 : 0)
+            + (Style.SuffixText.empty() ? 0 : 1 + VisibleWidth(Style.SuffixText))),
+        unitWidth(std::max(VisibleWidth(Style.FillChar), VisibleWidth(Style.UnfilledChar))),
+        showPercentage(Style.ShowPercentage)
+    {
+        if (!Label.empty()) {
+            head.append(Style.PrefixColor);
+            head.append(Label);
+        }
+        if (Style.ShowBrackets) {
+            head.append(Style.BracketColor);
+            head.push_back('[');
+            middle.append(Style.BracketColor);
+            middle.push_back(']');
+        }
+        head.append(Style.FillColor);
+
+        if (Style.ShowPercentage) {
+            middle.append(Style.TextColor);
+            middle.push_back(' ');
+            tail.push_back('%');
+        }
+        if (!Style.SuffixText.empty()) {
+            tail.push_back(' ');
+            tail.append(Style.SuffixColor);
+            tail.append(Style.SuffixText);
+        }
+        if (Style.ResetColorOnCompletion) {
+            tail.append(Color::RESET);
+        }
+
+        if (barWidth != FILL_AVAILABLE_WIDTH) {
+            detail::RepeatedRun(fillRun, fillChar, barWidth);
+            detail::RepeatedRun(unfilledRun, unfilledChar, barWidth);
+        }
+    }
+
+    /**
+     * @brief Appends the bar for the given progress to Out.
+     * @param Out The string to append to.
+     * @param CurrentPercentage The current value, clamped to [0, MaxPercentage].
+     * @param MaxPercentage The value at which the bar is full.
+     * @return Out.
+     */
+    CONSOLETOOLS_INLINE std::string& ProgressBarWidget::RenderTo(std::string& Out, int CurrentPercentage, int MaxPercentage) {
+        int width = (barWidth == FILL_AVAILABLE_WIDTH) ? detail::FillCount(fixedWidth, unitWidth) : barWidth;
+
+        int current = std::min(std::max(CurrentPercentage, 0), MaxPercentage);
+        double progress = (MaxPercentage != 0)
+            ? static_cast<double>(current) / MaxPercentage
+            : 0.0;
+        int filledWidth = static_cast<int>(progress * width);
+        std::string_view filled = detail::RepeatedRun(fillRun, fillChar, filledWidth);
+        std::string_view unfilled = detail::RepeatedRun(unfilledRun, unfilledChar, width - filledWidth);
+
+        // Room for everything, with up to three digits of percentage; trimmed once written.
+        std::size_t start = Out.size();
+        Out.resize(start + head.size() + filled.size() + unfilledColor.size() + unfilled.size() + middle.size() + 3
+            + tail.size());
+        char* cursor = &Out[start];
+        cursor = detail::CopyTo(cursor, head);
+        cursor = detail::CopyTo(cursor, filled);
+        cursor = detail::CopyTo(cursor, unfilledColor);
+        cursor = detail::CopyTo(cursor, unfilled);
+        cursor = detail::CopyTo(cursor, middle);
+        if (showPercentage) {
+            cursor = std::to_chars(cursor, cursor + 3, static_cast<int>(progress * 100)).ptr;
+        }
+        cursor = detail::CopyTo(cursor, tail);
+        Out.resize(static_cast<std::size_t>(cursor - Out.data()));
+        return Out;
+    }
+
+    /**
+     * @brief Renders the bar for the given progress.
+     * @param CurrentPercentage The current value, clamped to [0, MaxPercentage].
+     * @param MaxPercentage The value at which the bar is full.
+     * @return The same string as AdvancedProgressBar() with this widget's style and label.
+     */
+    CONSOLETOOLS_INLINE std::string ProgressBarWidget::Render(int CurrentPercentage, int MaxPercentage) {
+        std::string bar;
+        RenderTo(bar, CurrentPercentage, MaxPercentage);
+        return bar;
+    }
+
+    /**
+     * @brief Render() into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view ProgressBarWidget::RenderView(int CurrentPercentage, int MaxPercentage) {
+        std::string& bar = detail::ViewBuffer();
+        RenderTo(bar, CurrentPercentage, MaxPercentage);
+        return bar;
+    }
+
+    /**
+     * @brief Lays out the colors and spacing of an AdvancedHeader(), and its lines unless they fill the width.
+     * @param Style The header's style; it is copied.
+     */
+    CONSOLETOOLS_INLINE HeaderWidget::HeaderWidget(const HeaderStyle& Style)
+        : leftLineColor(Style.LeftLineColor),
+        leftLineCharacter(Style.LeftLineCharacter),
+        rightLineCharacter(Style.RightLineCharacter),
+        leftCount(Style.LeftLineCharacterCount),
+        rightCount(Style.RightLineCharacterCount),
+        leftWidth(VisibleWidth(Style.LeftLineCharacter)),
+        rightWidth(VisibleWidth(Style.RightLineCharacter)),
+        spacingWidth(VisibleWidth(Style.SpacingCharacter))
+    {
+        beforeText.append(Style.SpacingCharacterColor);
+        beforeText.append(Style.SpacingCharacter);
+        beforeText.append(Style.HeaderTextColor);
+
+        afterText.append(Style.SpacingCharacterColor);
+        afterText.append(Style.SpacingCharacter);
+        afterText.append(Style.RightLineColor);
+
+        if (Style.ResetColorOnEnd) {
+            end = Color::RESET;
+        }
+
+        if (leftCount != FILL_AVAILABLE_WIDTH) {
+            detail::RepeatedRun(leftRun, leftLineCharacter, leftCount);
+        }
+        if (rightCount != FILL_AVAILABLE_WIDTH) {
+            detail::RepeatedRun(rightRun, rightLineCharacter, rightCount);
+        }
+    }
+
+    /**
+     * @brief Appends the header around HeaderText to Out.
+     * @param Out The string to append to.
+     * @param HeaderText The text between the lines.
+     * @return Out.
+     */
+    CONSOLETOOLS_INLINE std::string& HeaderWidget::RenderTo(std::string& Out, std::string_view HeaderText) {
+        int left = leftCount;
+        int right = rightCount;
+        bool fillLeft = left == FILL_AVAILABLE_WIDTH;
+        bool fillRight = right == FILL_AVAILABLE_WIDTH;
+        if (fillLeft || fillRight) {
+            // Same split as AdvancedHeader().
+            int fixedWidth = VisibleWidth(HeaderText) + 2 * spacingWidth;
+            if (fillLeft && fillRight) {
+                left = detail::FillCount(fixedWidth, leftWidth + rightWidth);
+                right = left;
+            }
+            else if (fillLeft) {
+                left = detail::FillCount(fixedWidth + right * rightWidth, leftWidth);
+            }
+            else {
+                right = detail::FillCount(fixedWidth + left * leftWidth, rightWidth);
+            }
+        }
+        std::string_view leftLine = detail::RepeatedRun(leftRun, leftLineCharacter, left);
+        std::string_view rightLine = detail::RepeatedRun(rightRun, rightLineCharacter, right);
+
+        std::size_t start = Out.size();
+        Out.resize(start + leftLineColor.size() + leftLine.size() + beforeText.size() + HeaderText.size()
+            + afterText.size() + rightLine.size() + end.size());
+        char* cursor = &Out[start];
+        cursor = detail::CopyTo(cursor, leftLineColor);
+        cursor = detail::CopyTo(cursor, leftLine);
+        cursor = detail::CopyTo(cursor, beforeText);
+        cursor = detail::CopyTo(cursor, HeaderText);
+        cursor = detail::CopyTo(cursor, afterText);
+        cursor = detail::CopyTo(cursor, rightLine);
+        detail::CopyTo(cursor, end);
+        return Out;
+    }
+
+    /**
+     * @brief Renders the header around HeaderText.
+     * @param HeaderText The text between the lines.
+     * @return The same string as AdvancedHeader() with this widget's style.
+     */
+    CONSOLETOOLS_INLINE std::string HeaderWidget::Render(std::string_view HeaderText) {
+        std::string header;
+        RenderTo(header, HeaderText);
+        return header;
+    }
+
+    /**
+     * @brief Render() into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view HeaderWidget::RenderView(std::string_view HeaderText) {
+        std::string& header = detail::ViewBuffer();
+        RenderTo(header, HeaderText);
+        return header;
+    }
+
+    /**
+     * @brief Lays out the bordered "[!] TYPE: " prefix of a notification, followed by its text color.
+     * @param Style The notification's style; it is copied.
+     */
+    CONSOLETOOLS_INLINE NotificationWidget::NotificationWidget(const NotificationStyle& Style) {
+        detail::AppendNotificationPrefix(prefix, Style.LeftBorderCharacter, Style.InsideCharacter,
+            Style.RightBorderCharacter, Style.NotificationTypeText, Style.BorderCharacterColor,
+            Style.InsideCharacterColor);
+        prefix.append(Style.NotificationTextColor);
+    }
+
+    /**
+     * @brief Appends a notification with NotificationText to Out.
+     * @param Out The string to append to.
+     * @param NotificationText The message.
+     * @return Out.
+     */
+    CONSOLETOOLS_INLINE std::string& NotificationWidget::RenderTo(std::string& Out, std::string_view NotificationText) const {
+        std::string_view reset = Color::RESET;
+        std::size_t start = Out.size();
+        Out.resize(start + prefix.size() + NotificationText.size() + reset.size());
+        char* cursor = &Out[start];
+        cursor = detail::CopyTo(cursor, prefix);
+        cursor = detail::CopyTo(cursor, NotificationText);
+        detail::CopyTo(cursor, reset);
+        return Out;
+    }
+
+    /**
+     * @brief Renders a notification with NotificationText.
+     * @param NotificationText The message.
+     * @return The same string as Notification() with this widget's style.
+     */
+    CONSOLETOOLS_INLINE std::string NotificationWidget::Render(std::string_view NotificationText) const {
+        std::string notification;
+        RenderTo(notification, NotificationText);
+        return notification;
+    }
+
+    /**
+     * @brief Render() into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    CONSOLETOOLS_INLINE std::string_view NotificationWidget::RenderView(std::string_view NotificationText) const {
+        std::string& notification = detail::ViewBuffer();
+        RenderTo(notification, NotificationText);
+        return notification;
+    }
+
+} // namespace ConsoleTools
+
+#undef CONSOLETOOLS_MEASURE
+#undef CONSOLETOOLS_MEASURE_APPEND
+#undef CONSOLETOOLS_MEASURE_BYTES
+
+#endif // CONSOLE_TOOLS_CPP
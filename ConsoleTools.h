@@ -13,6 +13,78 @@
 #include <stdexcept>
 #include <vector>
 #include <limits>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <iosfwd>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <optional>
+#include <initializer_list>
+#include <condition_variable>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_jthread)
+#include <stop_token>
+#define CONSOLETOOLS_HAS_STOP_TOKEN 1
+#else
+#define CONSOLETOOLS_HAS_STOP_TOKEN 0
+#endif
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define CONSOLETOOLS_HAS_PMR 1
+#else
+#define CONSOLETOOLS_HAS_PMR 0
+#endif
+
+// Format strings are checked at compile time where consteval exists (C++20), at run time otherwise.
+#if defined(__cpp_consteval)
+#define CONSOLETOOLS_CONSTEVAL consteval
+#else
+#define CONSOLETOOLS_CONSTEVAL constexpr
+#endif
+
+/**
+ * @def CONSOLETOOLS_HEADER_ONLY
+ * @brief Define before including ConsoleTools.h (in every translation unit) to use the library
+ * header-only: the implementation is pulled in as inline functions, so calls can be inlined
+ * and constant-argument calls folded. ConsoleTools.cpp must then sit next to ConsoleTools.h
+ * and must not be compiled separately.
+ */
+#ifdef CONSOLETOOLS_HEADER_ONLY
+#define CONSOLETOOLS_INLINE inline
+#define CONSOLETOOLS_CONSTEXPR constexpr
+#else
+#define CONSOLETOOLS_INLINE
+#define CONSOLETOOLS_CONSTEXPR
+#endif
+
+/**
+ * @def CONSOLETOOLS_MIN_LOG_LEVEL
+ * @brief Lowest LogLevel (as an integer, 0 = Trace ... 6 = Off) compiled into the program.
+ * Log calls below this level are removed at compile time, arguments included.
+ */
+#ifndef CONSOLETOOLS_MIN_LOG_LEVEL
+#define CONSOLETOOLS_MIN_LOG_LEVEL 0
+#endif
+
+/**
+ * @def CONSOLETOOLS_ENABLE_INSTRUMENTATION
+ * @brief Set to 1 (for the library and everything including it) to record call counts, bytes,
+ * allocations and latency histograms for the builders and the output path. Off by default, in
+ * which case the measurements are not compiled in at all.
+ */
+#ifndef CONSOLETOOLS_ENABLE_INSTRUMENTATION
+#define CONSOLETOOLS_ENABLE_INSTRUMENTATION 0
+#endif
 
 namespace ConsoleTools {
 
@@ -47,6 +119,196 @@ namespace ConsoleTools {
         // follow the format of [static inline constexpr const char* COLORNAME = "ANSI_CODE"]
     };
 
+    /**
+     * @brief Pass as a line count or bar width to size the widget to the current terminal width.
+     */
+    inline constexpr int FILL_AVAILABLE_WIDTH = -1;
+
+    // Clocks
+
+    /**
+     * @class Clock
+     * @brief Source of time for everything that animates (spinners, typing effect, capture timestamps).
+     */
+    class Clock {
+    public:
+        using TimePoint = std::chrono::steady_clock::time_point;
+        using Duration = std::chrono::steady_clock::duration;
+
+        virtual ~Clock() = default;
+        virtual TimePoint Now() const = 0;
+        virtual void SleepUntil(TimePoint Deadline) = 0;
+
+        /**
+         * @brief Like SleepUntil(), but returns early when Condition is notified. Lock must be held.
+         */
+        virtual void WaitUntil(std::condition_variable_any& Condition, std::unique_lock<std::mutex>& Lock,
+            TimePoint Deadline) = 0;
+
+        /**
+         * @brief For background timers: blocks until the clock reaches Deadline or Condition is notified.
+         * Unlike WaitUntil() this never moves a virtual clock forward.
+         */
+        virtual void FollowUntil(std::condition_variable_any& Condition, std::unique_lock<std::mutex>& Lock,
+            TimePoint Deadline)
+        {
+            WaitUntil(Condition, Lock, Deadline);
+        }
+
+        void SleepFor(Duration Time) { SleepUntil(Now() + Time); }
+    };
+
+    /**
+     * @class SystemClock
+     * @brief Clock backed by std::chrono::steady_clock. This is the default.
+     */
+    class SystemClock : public Clock {
+    public:
+        TimePoint Now() const override;
+        void SleepUntil(TimePoint Deadline) override;
+        void WaitUntil(std::condition_variable_any& Condition, std::unique_lock<std::mutex>& Lock,
+            TimePoint Deadline) override;
+    };
+
+    /**
+     * @class VirtualClock
+     * @brief Clock that only moves when told to. Sleeping and waiting jump straight to the deadline,
+     * so animations run at full speed and produce the same frames and timestamps on every run;
+     * FollowUntil() blocks until some other thread has moved the clock far enough.
+     */
+    class VirtualClock : public Clock {
+    public:
+        explicit VirtualClock(TimePoint Start = TimePoint());
+        TimePoint Now() const override;
+        void SleepUntil(TimePoint Deadline) override;
+        void WaitUntil(std::condition_variable_any& Condition, std::unique_lock<std::mutex>& Lock,
+            TimePoint Deadline) override;
+        void FollowUntil(std::condition_variable_any& Condition, std::unique_lock<std::mutex>& Lock,
+            TimePoint Deadline) override;
+        void Advance(Duration Time);
+
+    private:
+        std::atomic<Duration::rep> ticks;
+    };
+
+    Clock& GetClock();
+    void SetClock(Clock* NewClock);
+    void SeedTypingEffect(std::uint32_t Seed);
+
+    // Output
+
+    /**
+     * @class OutputSink
+     * @brief Destination for everything ConsoleTools prints itself (menus, spinners, typing effects, ...).
+     */
+    class OutputSink {
+    public:
+        virtual ~OutputSink() = default;
+        virtual void Write(std::string_view Bytes) = 0;
+        virtual void Flush() {}
+
+        /**
+         * @brief Bytes accepted but not yet handed to the operating system because it could not take them.
+         */
+        virtual std::size_t PendingBytes() const { return 0; }
+
+        /**
+         * @brief Writes several pieces as if concatenated. Sinks that can gather-write override this.
+         */
+        virtual void WriteGather(const std::string_view* Parts, std::size_t Count) {
+            for (std::size_t i = 0; i < Count; i++) {
+                Write(Parts[i]);
+            }
+        }
+    };
+
+    /**
+     * @class StreamOutputSink
+     * @brief OutputSink that forwards to a std::ostream. The default sink wraps std::cout.
+     */
+    class StreamOutputSink : public OutputSink {
+    public:
+        explicit StreamOutputSink(std::ostream& Stream);
+        void Write(std::string_view Bytes) override;
+        void Flush() override;
+
+    private:
+        std::ostream* stream;
+    };
+
+    namespace detail {
+        struct SavedDescriptorFlags;
+    } // namespace detail
+
+    /**
+     * @class FileDescriptorSink
+     * @brief OutputSink that writes straight to a file descriptor, bypassing iostreams.
+     *
+     * Output collects in a fixed buffer and reaches the descriptor only on Flush(), when the buffer
+     * would overflow, or on destruction. An overflowing write sends the buffered bytes and the new
+     * ones together with a single writev().
+     *
+     * After SetNonBlocking(true), writes never wait for a slow terminal: whatever the kernel does not
+     * accept (EAGAIN) stays in a backlog that later writes and flushes retry, and PendingBytes() reports
+     * it. Only a backlog beyond MaxBacklog makes a write wait.
+     */
+    class FileDescriptorSink : public OutputSink {
+    public:
+        static constexpr std::size_t DefaultBufferSize = 8192;
+        static constexpr std::size_t MaxBacklog = 1024 * 1024;
+
+        explicit FileDescriptorSink(int Descriptor, std::size_t BufferSize = DefaultBufferSize);
+        ~FileDescriptorSink() override;
+        FileDescriptorSink(const FileDescriptorSink&) = delete;
+        FileDescriptorSink& operator=(const FileDescriptorSink&) = delete;
+
+        void Write(std::string_view Bytes) override;
+        void WriteGather(const std::string_view* Parts, std::size_t Count) override;
+        void Flush() override;
+        std::size_t PendingBytes() const override { return pendingBytes.load(std::memory_order_relaxed); }
+
+        bool SetNonBlocking(bool NonBlocking);
+        void Drain();
+        long QueuedBytes() const;
+
+        int Descriptor() const { return descriptor; }
+        std::uint64_t SystemCalls() const { return systemCalls.load(std::memory_order_relaxed); }
+        std::uint64_t WouldBlockCount() const { return wouldBlock.load(std::memory_order_relaxed); }
+
+    private:
+        void WriteLocked(const std::string_view* Parts, std::size_t Count, bool Wait);
+
+        std::mutex mutex;
+        int descriptor;
+        std::unique_ptr<char[]> buffer;
+        std::size_t capacity;
+        std::size_t used = 0;
+        std::string backlog;
+        bool nonBlocking = false;
+        int originalFlags = -1;
+        detail::SavedDescriptorFlags* savedFlags = nullptr;
+        std::atomic<std::size_t> pendingBytes{ 0 };
+        std::atomic<std::uint64_t> systemCalls{ 0 };
+        std::atomic<std::uint64_t> wouldBlock{ 0 };
+    };
+
+    /**
+     * @enum OutputBackend
+     * @brief What the default sink (used while no sink is installed) writes through.
+     */
+    enum class OutputBackend : int {
+        Stream = 0,         // std::cout
+        FileDescriptor = 1  // FileDescriptorSink on standard output
+    };
+
+    OutputSink& GetOutputSink();
+    void SetOutputSink(OutputSink* Sink);
+    OutputBackend GetOutputBackend();
+    void SetOutputBackend(OutputBackend Backend);
+    void Print(std::string_view Text);
+    void Print(std::initializer_list<std::string_view> Parts);
+    void FlushOutput();
+
     // Function Declarations
 
     void PauseConsole(const std::string& message);
@@ -125,6 +387,2062 @@ namespace ConsoleTools {
         const std::string InputQuestionColor,
         const std::string ErrorColor);
 
+#if CONSOLETOOLS_HAS_STOP_TOKEN
+    bool PauseConsole(const std::string& message, std::stop_token Stop);
+
+    bool PrintTypingTextEffect(const std::string& Text,
+        int MinDelayMilliseconds,
+        int MaxDelayMilliseconds,
+        std::stop_token Stop);
+
+    bool PrintSpinner(int SpinDurationMs, int SpinSpeedMs, std::stop_token Stop);
+#endif
+
+    // Logging
+
+    /**
+     * @enum LogLevel
+     * @brief Severity levels understood by the Logger, ordered from most to least verbose.
+     */
+    enum class LogLevel : int {
+        Trace = 0,
+        Debug = 1,
+        Info = 2,
+        Warning = 3,
+        Error = 4,
+        Fatal = 5,
+        Off = 6
+    };
+
+    namespace detail {
+        /**
+         * @brief 64-bit FNV-1a hash, used to key caches and suppression tables by text.
+         */
+        constexpr std::uint64_t Fnv1a(std::string_view Text,
+            std::uint64_t Hash = 14695981039346656037ull)
+        {
+            for (char c : Text) {
+                Hash ^= static_cast<unsigned char>(c);
+                Hash *= 1099511628211ull;
+            }
+            return Hash;
+        }
+
+        std::string& ThreadLogBuffer();
+
+        /**
+         * @class LogBufferScope
+         * @brief Lends Logger::Log() a buffer to assemble a message in: the calling thread's buffer, or a
+         * buffer of its own when a lazily evaluated argument logs while an outer message is being built.
+         */
+        class LogBufferScope {
+        public:
+            LogBufferScope();
+            ~LogBufferScope();
+            LogBufferScope(const LogBufferScope&) = delete;
+            LogBufferScope& operator=(const LogBufferScope&) = delete;
+
+            std::string& Buffer() { return *buffer; }
+
+        private:
+            std::string* buffer;
+            std::string fallback;
+        };
+
+        template <typename T>
+        void AppendLogArgument(std::string& Buffer, T&& Argument) {
+            using Type = std::decay_t<T>;
+            if constexpr (std::is_same_v<Type, bool>) {
+                Buffer.append(Argument ? "true" : "false");
+            }
+            else if constexpr (std::is_same_v<Type, char>) {
+                Buffer.push_back(Argument);
+            }
+            else if constexpr (std::is_arithmetic_v<Type>) {
+                Buffer.append(std::to_string(Argument));
+            }
+            else if constexpr (std::is_convertible_v<T, std::string_view>) {
+                Buffer.append(std::string_view(Argument));
+            }
+            else if constexpr (std::is_invocable_v<T>) {
+                // Lazy argument: only evaluated once the level is known to be enabled.
+                AppendLogArgument(Buffer, Argument());
+            }
+            else {
+                static_assert(std::is_invocable_v<T>, "Unsupported log argument type");
+            }
+        }
+
+        template <typename First, typename... Rest>
+        std::string_view SuppressionTemplate(const First& Template, const Rest&...) {
+            if constexpr (std::is_convertible_v<const First&, std::string_view>) {
+                return std::string_view(Template);
+            }
+            else {
+                return {};
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @class MessageSuppressor
+     * @brief Deduplicates and rate-limits messages keyed by their template text.
+     *
+     * Every distinct template gets a token bucket (kept as a single atomic "theoretical arrival
+     * time") in a fixed-size table. Messages over the limit are counted instead of printed, and the
+     * count is reported as "(repeated N times)" on the next message that gets through. Deciding
+     * takes no lock: only claiming a slot for a new template is serialized, per slot. A slot is
+     * reused once its bucket has refilled and it has no unreported copies, so messages that embed
+     * ids or timestamps do not fill the table for good. When they arrive too fast for that, the
+     * messages without a slot share one overflow bucket rather than going unlimited.
+     * Time is read through GetClock().
+     */
+    class MessageSuppressor {
+    public:
+        static constexpr std::size_t SlotCount = 1024;
+
+        MessageSuppressor(double MessagesPerSecond, int BurstSize);
+
+        MessageSuppressor(const MessageSuppressor&) = delete;
+        MessageSuppressor& operator=(const MessageSuppressor&) = delete;
+
+        bool Allow(std::string_view Template, std::uint64_t& RepeatedCount);
+        std::string Filter(const std::string& Message);
+        std::vector<std::string> TakeSummaries();
+
+    private:
+        /**
+         * @struct Slot
+         * @brief One token bucket. control holds the slot's state (Empty, Claiming or Live) times
+         * StateUnit plus the number of threads reading it; key and text are only written while the
+         * slot is Claiming, which a claimer can enter only when nobody reads the slot.
+         */
+        struct Slot {
+            std::atomic<std::uint32_t> control{ 0 };
+            std::atomic<std::uint64_t> key{ 0 };
+            std::string text;
+            std::atomic<std::int64_t> theoreticalArrival{ 0 };
+            std::atomic<std::uint64_t> suppressed{ 0 };
+        };
+
+        static constexpr std::uint32_t StateUnit = 1u << 24;
+        static constexpr std::uint32_t Empty = 0;
+        static constexpr std::uint32_t Claiming = 1;
+        static constexpr std::uint32_t Live = 2;
+
+        Slot* FindSlot(std::uint64_t Key, std::string_view Template, std::int64_t Now);
+        bool Claim(Slot& Target, std::uint32_t Expected, std::uint64_t Key, std::string_view Template, std::int64_t Now);
+
+        std::int64_t emissionInterval;
+        std::int64_t burstTolerance;
+        std::unique_ptr<Slot[]> slots;
+        Slot overflow;
+    };
+
+    MessageSuppressor& DefaultSuppressor();
+    std::string RateLimitedWarning(const std::string& Message);
+
+    /**
+     * @class Logger
+     * @brief Thread-safe leveled logger that styles its output like Error() and Warning().
+     *
+     * Each line is assembled in a per-thread buffer and written with a single call while
+     * holding the output lock, so lines from different threads never interleave.
+     */
+    class Logger {
+    public:
+        static constexpr LogLevel CompiledMinLevel = static_cast<LogLevel>(CONSOLETOOLS_MIN_LOG_LEVEL);
+
+        explicit Logger(std::ostream& Output);
+
+        void SetLevel(LogLevel Level);
+        LogLevel GetLevel() const;
+        void SetOutput(std::ostream& Output);
+        void SetShowTimestamps(bool ShowTimestamps);
+        void SetSuppressor(MessageSuppressor* Suppressor);
+
+        bool IsEnabled(LogLevel Level) const {
+            return static_cast<int>(Level) >= static_cast<int>(CompiledMinLevel)
+                && static_cast<int>(Level) < static_cast<int>(LogLevel::Off)
+                && static_cast<int>(Level) >= level.load(std::memory_order_relaxed);
+        }
+
+        // Arguments are concatenated; callables are invoked only if the level is enabled.
+        template <LogLevel Level, typename... Args>
+        void Log(Args&&... Arguments) {
+            if constexpr (static_cast<int>(Level) >= static_cast<int>(CompiledMinLevel)) {
+                Log(Level, std::forward<Args>(Arguments)...);
+            }
+        }
+
+        template <typename... Args>
+        void Log(LogLevel Level, Args&&... Arguments) {
+            if (!IsEnabled(Level)) {
+                return;
+            }
+
+            // Suppression is keyed by the first (template) argument and runs before formatting.
+            std::uint64_t repeatedCount = 0;
+            if constexpr (sizeof...(Args) > 0) {
+                MessageSuppressor* limiter = suppressor.load(std::memory_order_acquire);
+                std::string_view keyText = detail::SuppressionTemplate(Arguments...);
+                if (limiter != nullptr && !keyText.empty() && !limiter->Allow(keyText, repeatedCount)) {
+                    return;
+                }
+            }
+
+            detail::LogBufferScope scope;
+            std::string& buffer = scope.Buffer();
+            buffer.clear();
+            (detail::AppendLogArgument(buffer, std::forward<Args>(Arguments)), ...);
+            Write(Level, buffer, repeatedCount);
+        }
+
+        void Write(LogLevel Level, std::string_view Message, std::uint64_t RepeatedCount = 0);
+
+    private:
+        std::atomic<int> level;
+        std::atomic<bool> showTimestamps;
+        std::atomic<MessageSuppressor*> suppressor;
+        std::ostream* output;
+        std::mutex outputMutex;
+    };
+
+    Logger& DefaultLogger();
+
+    // Render caching
+
+    /**
+     * @class RenderCache
+     * @brief Bounded LRU cache of rendered widget strings, keyed by a hash of the render inputs.
+     *
+     * Keys are compared in full on lookup, so a hash collision is a miss, never a wrong result.
+     * A cache is not thread-safe; the Cached* builders use one cache per thread.
+     */
+    class RenderCache {
+    public:
+        explicit RenderCache(std::size_t Capacity);
+
+        const std::string* Find(std::uint64_t Hash, std::string_view Key);
+        const std::string& Store(std::uint64_t Hash, std::string_view Key, std::string Rendered);
+
+        void SetCapacity(std::size_t Capacity);
+        void Clear();
+        std::size_t Size() const { return index.size(); }
+        std::uint64_t Hits() const { return hits; }
+        std::uint64_t Misses() const { return misses; }
+
+    private:
+        struct Entry {
+            std::uint64_t Hash;
+            std::string Key;
+            std::string Rendered;
+        };
+
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+        std::size_t capacity;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    RenderCache& ThreadRenderCache();
+
+    const std::string& CachedProgressBar(int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        const std::string& BarColor,
+        bool ShowPercentage,
+        const std::string& PercentageColor);
+
+    const std::string& CachedAdvancedProgressBar(int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        const std::string& PrefixText,
+        const std::string& SuffixText,
+        const std::string& FillChar,
+        const std::string& UnfilledChar,
+        const std::string& FillColor,
+        const std::string& UnfilledColor,
+        const std::string& TextColor,
+        const std::string& PrefixColor,
+        const std::string& SuffixColor,
+        const std::string& BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion);
+
+    // Terminal size
+
+    /**
+     * @struct TerminalSize
+     * @brief Width and height of the terminal in character cells.
+     */
+    struct TerminalSize {
+        int Columns;
+        int Rows;
+    };
+
+    TerminalSize GetTerminalSize();
+    TerminalSize RefreshTerminalSize();
+    std::uint64_t TerminalSizeGeneration();
+    bool StartTerminalResizeWatcher();
+    void StopTerminalResizeWatcher();
+    CONSOLETOOLS_CONSTEXPR int VisibleWidth(std::string_view Text);
+
+    // Terminal state
+
+    /**
+     * @class TerminalStateGuard
+     * @brief Puts the terminal back the way it was when the program ends, however it ends.
+     *
+     * While a guard exists, fatal and terminating signals (SIGINT, SIGTERM, SIGHUP, SIGQUIT, SIGSEGV,
+     * SIGBUS, SIGFPE, SIGILL, SIGABRT) that end the program with their default action first reset colors
+     * and undo every mode changed through the functions below. If the program had its own handler it
+     * runs instead, and only faults (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT) restore the terminal
+     * before it, so a SIGINT handler that cancels work and returns finds the terminal as it left it.
+     * Destroying the guard restores the terminal and removes the handlers.
+     */
+    class TerminalStateGuard {
+    public:
+        TerminalStateGuard();
+        ~TerminalStateGuard();
+        TerminalStateGuard(const TerminalStateGuard&) = delete;
+        TerminalStateGuard& operator=(const TerminalStateGuard&) = delete;
+    };
+
+    void HideCursor();
+    void ShowCursor();
+    void EnterAlternateScreen();
+    void LeaveAlternateScreen();
+    bool EnableRawMode();
+    void DisableRawMode();
+    void RestoreTerminalState();
+
+    // Instrumentation
+
+    /**
+     * @class LogLinearHistogram
+     * @brief HDR-style histogram of non-negative integers (for example latencies in nanoseconds).
+     *
+     * Every power of two is split into SubBuckets equal buckets, so any recorded value is known to
+     * within 1/SubBuckets (about 6%) from 0 up to 2^MaxValueBits. Larger values land in the last bucket.
+     * Histograms with the same layout merge by adding bucket counts.
+     */
+    class LogLinearHistogram {
+    public:
+        static constexpr int SubBucketBits = 4;
+        static constexpr int SubBuckets = 1 << SubBucketBits;
+        static constexpr int MaxValueBits = 44;
+        static constexpr int BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBuckets;
+
+        static constexpr int BucketIndex(std::uint64_t Value) {
+            if (Value >= (std::uint64_t{ 1 } << MaxValueBits)) {
+                return BucketCount - 1;
+            }
+            if (Value < static_cast<std::uint64_t>(SubBuckets)) {
+                return static_cast<int>(Value);
+            }
+            int shift = HighestBit(Value) - SubBucketBits;
+            return (shift + 1) * SubBuckets + static_cast<int>((Value >> shift) & (SubBuckets - 1));
+        }
+
+        static constexpr std::uint64_t BucketLowerBound(int Index) {
+            if (Index < SubBuckets) {
+                return static_cast<std::uint64_t>(Index);
+            }
+            int shift = Index / SubBuckets - 1;
+            return static_cast<std::uint64_t>(SubBuckets + Index % SubBuckets) << shift;
+        }
+
+        static constexpr std::uint64_t BucketUpperBound(int Index) {
+            return (Index + 1 < BucketCount) ? BucketLowerBound(Index + 1) : (std::uint64_t{ 1 } << MaxValueBits);
+        }
+
+        LogLinearHistogram();
+
+        void Record(std::uint64_t Value, std::uint64_t Count = 1);
+        void RecordBucket(int Index, std::uint64_t Count);
+        void SetRange(std::uint64_t Min, std::uint64_t Max);
+        void Merge(const LogLinearHistogram& Other);
+        void Clear();
+
+        std::uint64_t Count() const { return count; }
+        std::uint64_t Min() const { return count ? min : 0; }
+        std::uint64_t Max() const { return count ? max : 0; }
+        double Mean() const;
+        std::uint64_t Percentile(double Percent) const;
+        std::uint64_t BucketValue(int Index) const { return buckets[static_cast<std::size_t>(Index)]; }
+
+    private:
+        static constexpr int HighestBit(std::uint64_t Value) {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - __builtin_clzll(Value);
+#else
+            int bit = 0;
+            while (Value >>= 1) {
+                bit++;
+            }
+            return bit;
+#endif
+        }
+
+        std::vector<std::uint64_t> buckets;
+        std::uint64_t count = 0;
+        std::uint64_t min = 0;
+        std::uint64_t max = 0;
+        double sum = 0.0;
+    };
+
+    /**
+     * @enum Metric
+     * @brief What the instrumentation measures. Builders are counted together with their
+     * pmr and View variants.
+     */
+    enum class Metric : int {
+        Spacing,
+        Header,
+        AdvancedHeader,
+        ProgressBar,
+        AdvancedProgressBar,
+        Error,
+        Warning,
+        Notification,
+        CachedProgressBar,
+        CachedAdvancedProgressBar,
+        SpinnerFrame,
+        LogWrite,
+        Print,
+        Flush,
+        Count
+    };
+
+    /**
+     * @struct MetricSnapshot
+     * @brief Totals for one Metric across all threads. Latency is in nanoseconds.
+     */
+    struct MetricSnapshot {
+        Metric Id;
+        std::string_view Name;
+        std::uint64_t Calls = 0;
+        std::uint64_t Bytes = 0;
+        std::uint64_t Allocations = 0;
+        LogLinearHistogram Latency;
+    };
+
+    inline constexpr bool INSTRUMENTATION_ENABLED = CONSOLETOOLS_ENABLE_INSTRUMENTATION != 0;
+
+    std::string_view MetricName(Metric Id);
+    std::vector<MetricSnapshot> TakeInstrumentationSnapshot();
+    std::string DumpInstrumentation();
+    void ResetInstrumentation();
+
+    // Frame pacing
+
+    /**
+     * @class FrameMonitor
+     * @brief Decides when a live widget may draw its next frame, so a slow terminal costs frames
+     * instead of stalling the program.
+     *
+     * The interval between frames starts at MinInterval. It doubles (up to MaxInterval) whenever a
+     * frame took more than a quarter of the interval to write or left bytes pending in the sink, and
+     * shrinks back by an eighth per frame once writes are fast again. Frames asked for too early, or
+     * while the sink still has a backlog, are dropped; widgets redraw their latest state next time.
+     * Only one render loop should drive a monitor; the counters may be read from any thread.
+     */
+    class FrameMonitor {
+    public:
+        explicit FrameMonitor(std::chrono::milliseconds MinInterval = std::chrono::milliseconds(16),
+            std::chrono::milliseconds MaxInterval = std::chrono::milliseconds(1000));
+
+        bool ShouldDraw(Clock::TimePoint Now, std::size_t PendingBytes);
+        void FrameWritten(Clock::TimePoint Start, Clock::TimePoint End, std::size_t PendingBytes);
+        void Reset();
+
+        Clock::Duration Interval() const { return Clock::Duration(interval.load(std::memory_order_relaxed)); }
+        std::uint64_t FramesDrawn() const { return drawn.load(std::memory_order_relaxed); }
+        std::uint64_t FramesDropped() const { return dropped.load(std::memory_order_relaxed); }
+        std::uint64_t BackloggedFrames() const { return backlogged.load(std::memory_order_relaxed); }
+        LogLinearHistogram WriteLatency() const;
+
+    private:
+        Clock::Duration minInterval;
+        Clock::Duration maxInterval;
+        std::atomic<Clock::Duration::rep> interval;
+        Clock::TimePoint lastDraw{};
+        bool hasDrawn = false;
+        std::atomic<std::uint64_t> drawn{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+        std::atomic<std::uint64_t> backlogged{ 0 };
+        mutable std::mutex latencyMutex;
+        LogLinearHistogram latency;
+    };
+
+    // Capture and replay
+
+    /**
+     * @class CaptureSink
+     * @brief OutputSink that records every byte with a timestamp instead of printing it.
+     *
+     * Each Flush() (every animation frame ends with one) closes a frame, which gives
+     * bytes-per-frame and frames-per-second figures without a real terminal.
+     */
+    class CaptureSink : public OutputSink {
+    public:
+        /**
+         * @struct Chunk
+         * @brief One Write() or frame: where its bytes start in Bytes(), how many there are, and when it happened.
+         */
+        struct Chunk {
+            std::chrono::steady_clock::duration Time;
+            std::size_t Offset;
+            std::size_t Size;
+        };
+
+        CaptureSink();
+        void Write(std::string_view Bytes) override;
+        void Flush() override;
+        void Clear();
+
+        std::string Bytes() const;
+        std::vector<Chunk> Writes() const;
+        std::vector<Chunk> Frames() const;
+        double BytesPerFrame() const;
+        double FramesPerSecond() const;
+
+    private:
+        mutable std::mutex mutex;
+        std::chrono::steady_clock::time_point start;
+        std::string bytes;
+        std::vector<Chunk> writes;
+        std::vector<Chunk> frames;
+        std::size_t frameStart = 0;
+    };
+
+    /**
+     * @class VirtualTerminal
+     * @brief Minimal VT100 emulator that replays output into a grid of cells for assertions and diffs.
+     *
+     * Understands printable UTF-8 (wide characters take two cells), CR/LF/BS/TAB, cursor movement
+     * (CSI A B C D E F G H f), erase (CSI J, CSI K), cursor visibility (CSI ?25 h/l) and SGR colors and
+     * attributes. Line feeds also return to column 0, like a terminal with output post-processing.
+     */
+    class VirtualTerminal {
+    public:
+        /**
+         * @struct Cell
+         * @brief One character cell. Colors are stored as the escape code that selects them, so they
+         * compare equal to Color constants (an empty string means the default color).
+         */
+        struct Cell {
+            std::string Glyph = " ";
+            std::string Foreground;
+            std::string Background;
+            bool Bold = false;
+            bool Underline = false;
+            bool Inverse = false;
+
+            bool operator==(const Cell& Other) const;
+            bool operator!=(const Cell& Other) const { return !(*this == Other); }
+        };
+
+        VirtualTerminal(int Columns, int Rows);
+
+        void Feed(std::string_view Bytes);
+        void Replay(const CaptureSink& Capture);
+        void Reset();
+
+        int Columns() const { return columns; }
+        int Rows() const { return rows; }
+        int CursorRow() const { return cursorRow; }
+        int CursorColumn() const { return cursorColumn; }
+        bool CursorVisible() const { return cursorVisible; }
+        int ScrolledLines() const { return scrolledLines; }
+
+        const Cell& At(int Row, int Column) const;
+        std::string RowText(int Row) const;
+        std::string Text() const;
+        std::vector<std::string> Diff(const VirtualTerminal& Other) const;
+
+    private:
+        void PutCodepoint(std::string_view Glyph, int Width);
+        void LineFeed();
+        void ExecuteCsi(std::string_view Parameters, char Final);
+        void ApplySgr(std::string_view Parameters);
+        void EraseCells(int Row, int FromColumn, int ToColumn);
+        Cell& CellAt(int Row, int Column);
+
+        int columns;
+        int rows;
+        int cursorRow = 0;
+        int cursorColumn = 0;
+        bool wrapPending = false;
+        bool cursorVisible = true;
+        int scrolledLines = 0;
+        Cell pen;
+        std::vector<Cell> cells;
+        std::string pending; // incomplete escape or UTF-8 sequence carried over to the next Feed()
+    };
+
+    // Rendering to views
+
+    std::string_view SpacingView(int NumberOfSpaces);
+
+    std::string_view HeaderView(std::string_view LineCharacter,
+        int LineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor);
+
+    std::string_view AdvancedHeaderView(std::string_view LeftLineCharacter,
+        int LeftLineCharacterCount,
+        std::string_view RightLineCharacter,
+        int RightLineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LeftLineColor,
+        std::string_view RightLineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor,
+        bool ResetColorOnEnd);
+
+    std::string_view ProgressBarView(int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        std::string_view BarColor,
+        bool ShowPercentage,
+        std::string_view PercentageColor);
+
+    std::string_view AdvancedProgressBarView(int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        std::string_view PrefixText,
+        std::string_view SuffixText,
+        std::string_view FillChar,
+        std::string_view UnfilledChar,
+        std::string_view FillColor,
+        std::string_view UnfilledColor,
+        std::string_view TextColor,
+        std::string_view PrefixColor,
+        std::string_view SuffixColor,
+        std::string_view BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion);
+
+    std::string_view ErrorView(std::string_view Message);
+    std::string_view WarningView(std::string_view Message);
+
+    std::string_view NotificationView(std::string_view LeftBorderCharacter,
+        std::string_view InsideCharacter,
+        std::string_view RightBorderCharacter,
+        std::string_view NotificationTypeText,
+        std::string_view NotificationText,
+        std::string_view BorderCharacterColor,
+        std::string_view InsideCharacterColor,
+        std::string_view NotificationTextColor);
+
+#if CONSOLETOOLS_HAS_PMR
+    // Frame arenas
+
+    /**
+     * @class FrameArena
+     * @brief Per-frame monotonic arena for the std::pmr builder overloads.
+     *
+     * Everything built during a frame is carved out of one buffer and thrown away at once by
+     * Reset(). When a frame outgrows the buffer the overflow comes from the heap, and the next
+     * Reset() enlarges the buffer to cover it, so a steady redraw loop stops allocating after
+     * its first few frames. Not thread-safe; use one arena per rendering thread.
+     */
+    class FrameArena {
+    public:
+        explicit FrameArena(std::size_t InitialCapacity = 16 * 1024);
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        std::pmr::memory_resource* Resource();
+        void Reset();
+
+        std::size_t Capacity() const { return capacity; }
+        std::size_t OverflowBytes() const { return upstream.Bytes; }
+        std::size_t OverflowAllocations() const { return upstream.Allocations; }
+
+    private:
+        /**
+         * @class CountingResource
+         * @brief Heap resource that counts what the arena had to borrow beyond its buffer.
+         */
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            std::size_t Bytes = 0;
+            std::size_t Allocations = 0;
+
+        private:
+            void* do_allocate(std::size_t Size, std::size_t Alignment) override;
+            void do_deallocate(void* Pointer, std::size_t Size, std::size_t Alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& Other) const noexcept override;
+        };
+
+        std::unique_ptr<std::byte[]> buffer;
+        std::size_t capacity;
+        CountingResource upstream;
+        std::optional<std::pmr::monotonic_buffer_resource> arena;
+    };
+
+    std::pmr::string Spacing(std::pmr::memory_resource* Resource, int NumberOfSpaces);
+
+    std::pmr::string Header(std::pmr::memory_resource* Resource,
+        std::string_view LineCharacter,
+        int LineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor);
+
+    std::pmr::string AdvancedHeader(std::pmr::memory_resource* Resource,
+        std::string_view LeftLineCharacter,
+        int LeftLineCharacterCount,
+        std::string_view RightLineCharacter,
+        int RightLineCharacterCount,
+        std::string_view HeaderText,
+        std::string_view SpacingCharacter,
+        std::string_view LeftLineColor,
+        std::string_view RightLineColor,
+        std::string_view HeaderTextColor,
+        std::string_view SpacingCharacterColor,
+        bool ResetColorOnEnd);
+
+    std::pmr::string ProgressBar(std::pmr::memory_resource* Resource,
+        int CurrentProgress,
+        int MaxProgress,
+        int BarWidth,
+        std::string_view BarColor,
+        bool ShowPercentage,
+        std::string_view PercentageColor);
+
+    std::pmr::string AdvancedProgressBar(std::pmr::memory_resource* Resource,
+        int CurrentPercentage,
+        int MaxPercentage,
+        int BarWidth,
+        std::string_view PrefixText,
+        std::string_view SuffixText,
+        std::string_view FillChar,
+        std::string_view UnfilledChar,
+        std::string_view FillColor,
+        std::string_view UnfilledColor,
+        std::string_view TextColor,
+        std::string_view PrefixColor,
+        std::string_view SuffixColor,
+        std::string_view BracketColor,
+        bool ShowPercentage,
+        bool ShowBrackets,
+        bool ResetColorOnCompletion);
+
+    std::pmr::string Error(std::pmr::memory_resource* Resource, std::string_view Message);
+    std::pmr::string Warning(std::pmr::memory_resource* Resource, std::string_view Message);
+
+    std::pmr::string Notification(std::pmr::memory_resource* Resource,
+        std::string_view LeftBorderCharacter,
+        std::string_view InsideCharacter,
+        std::string_view RightBorderCharacter,
+        std::string_view NotificationTypeText,
+        std::string_view NotificationText,
+        std::string_view BorderCharacterColor,
+        std::string_view InsideCharacterColor,
+        std::string_view NotificationTextColor);
+#endif
+
+    // Spinners
+
+    /**
+     * @struct SpinnerFrames
+     * @brief A spinner animation: Count frames, each a string of the same visible width.
+     */
+    struct SpinnerFrames {
+        const std::string_view* Frames;
+        int Count;
+    };
+
+    namespace detail {
+        inline constexpr std::string_view LineSpinnerFrames[] = { "|", "/", "-", "\\" };
+        inline constexpr std::string_view DotsSpinnerFrames[] = { ".  ", ".. ", "...", " ..", "  .", "   " };
+        inline constexpr std::string_view BrailleSpinnerFrames[] = {
+            "⠋", "⠙", "⠹", "⠸", "⠼", "⠴", "⠦", "⠧", "⠇", "⠏" };
+        inline constexpr std::string_view ArcSpinnerFrames[] = {
+            "◜", "◠", "◝", "◞", "◡", "◟" };
+        inline constexpr std::string_view BarsSpinnerFrames[] = {
+            "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█",
+            "▇", "▆", "▅", "▄", "▃", "▂" };
+    } // namespace detail
+
+    /**
+     * @struct Spinners
+     * @brief Stores the built-in spinner frame tables for easy access.
+     */
+    struct Spinners {
+        static inline constexpr SpinnerFrames LINE = { detail::LineSpinnerFrames, 4 };
+        static inline constexpr SpinnerFrames DOTS = { detail::DotsSpinnerFrames, 6 };
+        static inline constexpr SpinnerFrames BRAILLE = { detail::BrailleSpinnerFrames, 10 };
+        static inline constexpr SpinnerFrames ARC = { detail::ArcSpinnerFrames, 6 };
+        static inline constexpr SpinnerFrames BARS = { detail::BarsSpinnerFrames, 14 };
+    };
+
+    /**
+     * @class SpinnerGroup
+     * @brief Animates many spinners, each with its own position and label, from one timer thread.
+     *
+     * Positions are relative to the cursor line: Row 0 is the line the cursor is on, Row 1 the line
+     * above it, and so on; Column is 1-based. Every tick redraws all spinners with a single write and
+     * leaves the cursor at the start of its line. SetLabel() never blocks and may be called from any thread.
+     * Frames are written outside the group's lock and paced by a FrameMonitor, so a slow terminal
+     * lowers the frame rate instead of holding up threads that update the spinners.
+     */
+    class SpinnerGroup {
+    public:
+        static constexpr std::size_t LabelCapacity = 64;
+
+        explicit SpinnerGroup(int Capacity, std::chrono::milliseconds Interval = std::chrono::milliseconds(80));
+        ~SpinnerGroup();
+        SpinnerGroup(const SpinnerGroup&) = delete;
+        SpinnerGroup& operator=(const SpinnerGroup&) = delete;
+
+        int Add(int Row, int Column, const SpinnerFrames& Frames = Spinners::BRAILLE,
+            std::string_view SpinnerColor = Color::CYAN);
+        void SetLabel(int Spinner, std::string_view Label);
+        void Complete(int Spinner, std::string_view FinalText, std::string_view FinalColor = Color::GREEN);
+
+        void Start();
+        void Stop();
+        void Render();
+        int Size() const { return count.load(std::memory_order_acquire); }
+        const FrameMonitor& Monitor() const { return monitor; }
+
+    private:
+        static constexpr std::size_t LabelWords = LabelCapacity / sizeof(std::uint64_t);
+
+        /**
+         * @struct Slot
+         * @brief One spinner. The label is a seqlock over atomic words, so writers and the
+         * render thread never wait on each other.
+         */
+        struct Slot {
+            int Row = 0;
+            int Column = 0;
+            int Width = 0;
+            SpinnerFrames Frames = Spinners::LINE;
+            std::string Style;
+            std::string FinalText;
+            bool Completed = false;
+            bool FinalDrawn = false;
+
+            std::atomic<std::uint32_t> labelSequence{ 0 };
+            std::atomic<std::uint32_t> labelLength{ 0 };
+            std::atomic<std::uint64_t> labelWords[LabelWords] = {};
+            std::uint32_t drawnSequence = 0;
+            int drawnLabelWidth = 0;
+        };
+
+        void AppendMove(int FromRow, int ToRow);
+        void RenderLocked(bool Final);
+        void DrawFrame(bool Final, bool Paced);
+
+        std::unique_ptr<Slot[]> slots;
+        int capacity;
+        std::atomic<int> count{ 0 };
+        std::chrono::milliseconds interval;
+        std::uint64_t tick = 0;
+        std::string frame;
+        FrameMonitor monitor;
+
+        std::mutex drawMutex;
+        std::mutex mutex;
+        std::condition_variable_any wake;
+        bool running = false;
+        bool stopRequested = false;
+        std::thread timer;
+    };
+
+    // Charts
+
+    /**
+     * @enum SeriesAggregate
+     * @brief How a chart combines several samples into one column when the series is longer than the chart is wide.
+     */
+    enum class SeriesAggregate : int {
+        Max = 0,
+        Mean = 1,
+        Min = 2
+    };
+
+    /**
+     * @class SeriesBuffer
+     * @brief Fixed-capacity ring buffer of samples for Sparkline() and MiniBarChart().
+     *
+     * Push() is O(1): once the buffer is full it overwrites the oldest sample, and two monotonic
+     * deques keep Min() and Max() of the stored samples up to date without rescanning. NaN and
+     * infinite samples are ignored. Not thread-safe; guard the buffer if several threads push to it.
+     */
+    class SeriesBuffer {
+    public:
+        explicit SeriesBuffer(std::size_t Capacity);
+
+        void Push(double Value);
+        void Clear();
+        std::size_t Downsample(double* Out, std::size_t Columns, SeriesAggregate Aggregate) const;
+
+        std::size_t Size() const { return size; }
+        std::size_t Capacity() const { return capacity; }
+        bool Empty() const { return size == 0; }
+        double Min() const { return size ? values[minQueue[minHead]] : 0.0; }
+        double Max() const { return size ? values[maxQueue[maxHead]] : 0.0; }
+        double Latest() const { return size ? values[next == 0 ? capacity - 1 : next - 1] : 0.0; }
+
+        /**
+         * @brief Returns a stored sample; 0 is the oldest, Size() - 1 the latest.
+         */
+        double operator[](std::size_t Index) const { return values[Wrap(Oldest() + Index)]; }
+
+    private:
+        std::size_t Wrap(std::size_t Slot) const { return Slot >= capacity ? Slot - capacity : Slot; }
+        std::size_t Oldest() const { return size == capacity ? next : 0; }
+        double Reduce(std::size_t First, std::size_t Last, SeriesAggregate Aggregate) const;
+
+        std::vector<double> values;
+        std::size_t capacity;
+        std::size_t size = 0;
+        std::size_t next = 0;   // slot the next sample goes into
+
+        // Slots of samples, oldest first, whose values only rise (minQueue) or fall (maxQueue).
+        std::vector<std::size_t> minQueue;
+        std::vector<std::size_t> maxQueue;
+        std::size_t minHead = 0;
+        std::size_t minCount = 0;
+        std::size_t maxHead = 0;
+        std::size_t maxCount = 0;
+    };
+
+    namespace detail {
+        inline constexpr std::string_view BlockEighths[] = {
+            " ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█" };
+    } // namespace detail
+
+    std::string Sparkline(const SeriesBuffer& Series,
+        int Width,
+        std::string_view SparklineColor = Color::CYAN,
+        SeriesAggregate Aggregate = SeriesAggregate::Max);
+
+    std::string_view SparklineView(const SeriesBuffer& Series,
+        int Width,
+        std::string_view SparklineColor = Color::CYAN,
+        SeriesAggregate Aggregate = SeriesAggregate::Max);
+
+    std::string MiniBarChart(const SeriesBuffer& Series,
+        int Width,
+        int Height,
+        std::string_view BarColor = Color::CYAN,
+        SeriesAggregate Aggregate = SeriesAggregate::Max);
+
+    std::string_view MiniBarChartView(const SeriesBuffer& Series,
+        int Width,
+        int Height,
+        std::string_view BarColor = Color::CYAN,
+        SeriesAggregate Aggregate = SeriesAggregate::Max);
+
+    // Histograms
+
+    /**
+     * @class ConcurrentHistogram
+     * @brief LogLinearHistogram that many threads can record into at once without locks.
+     *
+     * Each thread records into one of several shards (its own, as long as there are no more threads
+     * than shards) with a single relaxed atomic add, so millions of samples per second cost little.
+     * Snapshot() merges the shards. Only bucket counts are kept, so the Min(), Max() and Mean() of a
+     * snapshot are accurate to a bucket (about 6%). A thread with a plain LogLinearHistogram of its
+     * own, merged now and then, is faster still.
+     */
+    class ConcurrentHistogram {
+    public:
+        explicit ConcurrentHistogram(int Shards = 0);
+
+        void Record(std::uint64_t Value, std::uint64_t Count = 1);
+        LogLinearHistogram Snapshot() const;
+        LogLinearHistogram TakeInterval();
+        void Clear();
+        int Shards() const { return static_cast<int>(shardMask + 1); }
+
+    private:
+        std::size_t shardMask;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> buckets;
+    };
+
+    /**
+     * @enum HistogramLabels
+     * @brief How histogram widgets label values.
+     */
+    enum class HistogramLabels : int {
+        Plain = 0,      // 950, 12.3k, 4.5M
+        Nanoseconds = 1 // 950ns, 12.3µs, 4.5ms
+    };
+
+    namespace detail {
+        inline constexpr std::string_view HorizontalEighths[] = {
+            "", "▏", "▎", "▍", "▌", "▋", "▊", "▉", "█" };
+    } // namespace detail
+
+    std::string HistogramBars(const LogLinearHistogram& Histogram,
+        int Rows,
+        int BarWidth,
+        std::string_view BarColor = Color::CYAN,
+        std::string_view LabelColor = Color::GRAY,
+        HistogramLabels Labels = HistogramLabels::Nanoseconds);
+
+    std::string_view HistogramBarsView(const LogLinearHistogram& Histogram,
+        int Rows,
+        int BarWidth,
+        std::string_view BarColor = Color::CYAN,
+        std::string_view LabelColor = Color::GRAY,
+        HistogramLabels Labels = HistogramLabels::Nanoseconds);
+
+    /**
+     * @class HistogramHeatmap
+     * @brief Distribution over time drawn with Braille dots: time runs left to right (two slices per
+     * column) and values upwards on a log scale (four bands per row).
+     *
+     * A dot is set when any sample of its slice fell into its band; a cell's color shows the largest
+     * share of its slice that any of its dots holds, from the first palette color (few) to the last (most).
+     */
+    class HistogramHeatmap {
+    public:
+        HistogramHeatmap(int Columns, int Rows, std::uint64_t MinValue, std::uint64_t MaxValue,
+            std::vector<std::string> Palette = {});
+
+        void AddSlice(const LogLinearHistogram& Slice);
+        void Clear();
+        std::string Render(std::string_view LabelColor = Color::GRAY,
+            HistogramLabels Labels = HistogramLabels::Nanoseconds) const;
+
+        int Columns() const { return columns; }
+        int Rows() const { return rows; }
+        std::size_t Slices() const { return slices; }
+
+    private:
+        int columns;
+        int rows;
+        int bands;
+        std::uint64_t minValue;
+        std::uint64_t maxValue;
+        double logMin;
+        double bandsPerLog;
+        std::vector<std::string> palette;
+        std::vector<float> shares;  // ring of Columns * 2 slices, bands floats each
+        std::size_t next = 0;       // slot the next slice goes into
+        std::size_t slices = 0;
+    };
+
+    // Layout
+
+    /**
+     * @struct Rect
+     * @brief A rectangle of cells; Row and Column are 0-based from the top-left of the screen.
+     */
+    struct Rect {
+        int Row = 0;
+        int Column = 0;
+        int Width = 0;
+        int Height = 0;
+    };
+
+    /**
+     * @class FrameBuffer
+     * @brief Grid of cells that widgets are drawn into, then written to the terminal in one go.
+     *
+     * Write() interprets the colors and attributes of the builders' output and clips it to a region.
+     * Render() returns only the cells that differ from the previously rendered frame, addressed
+     * absolutely from the top-left of the screen (use it on the alternate screen). Combining marks
+     * are dropped.
+     */
+    class FrameBuffer {
+    public:
+        FrameBuffer(int Columns, int Rows);
+
+        void Resize(int Columns, int Rows);
+        void Clear();
+        void Clear(const Rect& Region);
+        int Write(const Rect& Region, std::string_view Text);
+        std::string_view Render();
+        void Invalidate() { fullRedraw = true; }
+
+        int Columns() const { return columns; }
+        int Rows() const { return rows; }
+        std::string RowText(int Row) const;
+
+    private:
+        /**
+         * @struct Cell
+         * @brief One cell: up to four bytes of UTF-8 and an interned style. Width 0 marks the
+         * right half of a wide character.
+         */
+        struct Cell {
+            std::uint32_t Glyph = ' ';
+            std::uint8_t Length = 1;
+            std::uint8_t Width = 1;
+            std::uint16_t Style = 0;
+
+            bool operator==(const Cell& Other) const {
+                return Glyph == Other.Glyph && Length == Other.Length && Width == Other.Width && Style == Other.Style;
+            }
+            bool operator!=(const Cell& Other) const { return !(*this == Other); }
+        };
+
+        std::uint16_t InternStyle(const VirtualTerminal::Cell& Pen);
+        void Touch(int Top, int Bottom);
+
+        int columns;
+        int rows;
+        std::vector<Cell> cells;
+        std::vector<Cell> shown;
+        bool fullRedraw = true;
+        // Rows written since the last Render(); only these are compared.
+        int dirtyTop = 0;
+        int dirtyBottom = 0;
+        std::vector<std::string> styles;
+        std::unordered_map<std::string, std::uint16_t> styleIds;
+        std::string output;
+    };
+
+    /**
+     * @struct LayoutSize
+     * @brief How much of its parent a region takes along the parent's direction: a fixed number of
+     * cells, a percentage, or a weighted share of what the fixed and percentage siblings leave over.
+     * Min is honoured while space lasts.
+     */
+    struct LayoutSize {
+        enum class Kind : int {
+            Fixed = 0,
+            Percent = 1,
+            Flex = 2
+        };
+
+        Kind Type = Kind::Flex;
+        int Value = 1;
+        int Min = 0;
+
+        static constexpr LayoutSize Fixed(int Cells) { return { Kind::Fixed, Cells, 0 }; }
+        static constexpr LayoutSize Percent(int Percentage) { return { Kind::Percent, Percentage, 0 }; }
+        static constexpr LayoutSize Flex(int Weight = 1) { return { Kind::Flex, Weight, 0 }; }
+        constexpr LayoutSize WithMin(int Cells) const { return { Type, Value, Cells }; }
+    };
+
+    /**
+     * @enum LayoutDirection
+     * @brief How a region arranges its children.
+     */
+    enum class LayoutDirection : int {
+        Row = 0,    // side by side, left to right
+        Column = 1  // stacked, top to bottom
+    };
+
+    /**
+     * @struct BorderStyle
+     * @brief The characters of a box border.
+     */
+    struct BorderStyle {
+        std::string_view TopLeft;
+        std::string_view TopRight;
+        std::string_view BottomLeft;
+        std::string_view BottomRight;
+        std::string_view Horizontal;
+        std::string_view Vertical;
+    };
+
+    /**
+     * @struct Borders
+     * @brief Stores the built-in border styles for easy access.
+     */
+    struct Borders {
+        static inline constexpr BorderStyle LIGHT = { "┌", "┐", "└", "┘", "─", "│" };
+        static inline constexpr BorderStyle HEAVY = { "┏", "┓", "┗", "┛", "━", "┃" };
+        static inline constexpr BorderStyle DOUBLE = { "╔", "╗", "╚", "╝", "═", "║" };
+        static inline constexpr BorderStyle ROUNDED = { "╭", "╮", "╰", "╯", "─", "│" };
+        static inline constexpr BorderStyle ASCII = { "+", "+", "+", "+", "-", "|" };
+    };
+
+    /**
+     * @class Layout
+     * @brief Tree of screen regions split into rows and columns, optionally bordered.
+     *
+     * Region 0 (ROOT) is the whole screen; Add() splits a region further. Geometry is computed by
+     * Resize() only when the screen size or the tree changed, so Bounds() and Content() are plain
+     * lookups. Call Resize() after changing the tree.
+     */
+    class Layout {
+    public:
+        static constexpr int ROOT = 0;
+
+        explicit Layout(LayoutDirection RootDirection = LayoutDirection::Column);
+
+        int Add(int Parent, LayoutSize Size, LayoutDirection Direction = LayoutDirection::Column);
+        void SetBorder(int Region, const BorderStyle& Style, std::string_view Title = {},
+            std::string_view BorderColor = {});
+        bool Resize(int Columns, int Rows);
+
+        const Rect& Bounds(int Region) const { return nodes[static_cast<std::size_t>(Region)].Bounds; }
+        const Rect& Content(int Region) const { return nodes[static_cast<std::size_t>(Region)].Content; }
+        int Regions() const { return static_cast<int>(nodes.size()); }
+
+        void DrawBorders(FrameBuffer& Frame) const;
+        int Draw(FrameBuffer& Frame, int Region, std::string_view Text) const;
+
+    private:
+        /**
+         * @struct Node
+         * @brief One region and its cached geometry.
+         */
+        struct Node {
+            int Parent = -1;
+            LayoutSize Size;
+            LayoutDirection Direction = LayoutDirection::Column;
+            std::vector<int> Children;
+            bool HasBorder = false;
+            BorderStyle Border;
+            std::string Title;
+            std::string BorderColor;
+            Rect Bounds;
+            Rect Content;
+        };
+
+        void Arrange(int Region);
+
+        std::vector<Node> nodes;
+        int columns = -1;
+        int rows = -1;
+        bool dirty = true;
+    };
+
+    // Text wrapping
+
+    /**
+     * @enum WrapMode
+     * @brief How WrapText() chooses line breaks. Greedy fills each line as far as it goes; Balanced
+     * (minimum raggedness) evens out line lengths within each paragraph, at the cost of buffering it.
+     */
+    enum class WrapMode : int {
+        Greedy = 0,
+        Balanced = 1
+    };
+
+    std::string WrapText(std::string_view Text,
+        int Width,
+        int HangingIndent = 0,
+        WrapMode Mode = WrapMode::Greedy);
+
+    std::string_view WrapTextView(std::string_view Text,
+        int Width,
+        int HangingIndent = 0,
+        WrapMode Mode = WrapMode::Greedy);
+
+    std::string WrappedNotification(std::string_view LeftBorderCharacter,
+        std::string_view InsideCharacter,
+        std::string_view RightBorderCharacter,
+        std::string_view NotificationTypeText,
+        std::string_view NotificationText,
+        std::string_view BorderCharacterColor,
+        std::string_view InsideCharacterColor,
+        std::string_view NotificationTextColor,
+        int Width = FILL_AVAILABLE_WIDTH,
+        WrapMode Mode = WrapMode::Greedy);
+
+    // Markup
+
+    /**
+     * @struct MarkupStyle
+     * @brief Style of a run of markup: a color (an index into detail::MarkupColors, 0 for none) and attributes.
+     */
+    struct MarkupStyle {
+        std::uint8_t Color = 0;
+        bool Bold = false;
+        bool Underline = false;
+
+        constexpr bool operator==(const MarkupStyle& Other) const {
+            return Color == Other.Color && Bold == Other.Bold && Underline == Other.Underline;
+        }
+        constexpr bool operator!=(const MarkupStyle& Other) const { return !(*this == Other); }
+    };
+
+    /**
+     * @struct MarkupRun
+     * @brief One piece of compiled markup: Length bytes of the template starting at Begin or, when
+     * Argument is not -1, the argument with that index, drawn in Style.
+     */
+    struct MarkupRun {
+        std::uint32_t Begin = 0;
+        std::uint32_t Length = 0;
+        std::int16_t Argument = -1;
+        MarkupStyle Style;
+    };
+
+    /**
+     * @struct FormatSpec
+     * @brief The layout part of a "{:spec}" field: [[fill]align][0][width][.precision][type].
+     * Align is '<', '>' or '^' (0: numbers right, text left); type is d, x, X, o, c, f, e, g or s.
+     */
+    struct FormatSpec {
+        char Fill = ' ';
+        char Align = 0;
+        bool ZeroPad = false;
+        int Width = 0;
+        int Precision = -1;
+        char Type = 0;
+    };
+
+    namespace detail {
+        /**
+         * @struct MarkupColorName
+         * @brief A color name usable in markup tags.
+         */
+        struct MarkupColorName {
+            std::string_view Name;
+            const char* Code;
+        };
+
+        inline constexpr MarkupColorName MarkupColors[] = {
+            { "", "" },
+            { "red", Color::RED }, { "orange", Color::ORANGE }, { "yellow", Color::YELLOW },
+            { "green", Color::GREEN }, { "blue", Color::BLUE }, { "purple", Color::PURPLE },
+            { "cyan", Color::CYAN }, { "white", Color::WHITE }, { "gray", Color::GRAY },
+            { "black", Color::BLACK }, { "light_red", Color::LIGHT_RED }, { "light_orange", Color::LIGHT_ORANGE },
+            { "light_yellow", Color::LIGHT_YELLOW }, { "light_green", Color::LIGHT_GREEN },
+            { "light_blue", Color::LIGHT_BLUE }, { "light_purple", Color::LIGHT_PURPLE },
+            { "light_cyan", Color::LIGHT_CYAN } };
+
+        /**
+         * @brief Applies the space-separated words of a tag ("red", "bold cyan", "u") to Style.
+         * @return false if a word is not a color or attribute, in which case the tag is plain text.
+         */
+        constexpr bool ApplyMarkupTag(std::string_view Tag, MarkupStyle& Style) {
+            if (Tag.empty()) {
+                return false;
+            }
+            while (!Tag.empty()) {
+                std::size_t space = Tag.find(' ');
+                std::string_view word = Tag.substr(0, space);
+                Tag = (space == std::string_view::npos) ? std::string_view() : Tag.substr(space + 1);
+                if (word == "b" || word == "bold") {
+                    Style.Bold = true;
+                    continue;
+                }
+                if (word == "u" || word == "underline") {
+                    Style.Underline = true;
+                    continue;
+                }
+                std::uint8_t color = 0;
+                for (std::size_t i = 1; i < sizeof(MarkupColors) / sizeof(MarkupColors[0]); i++) {
+                    if (MarkupColors[i].Name == word) {
+                        color = static_cast<std::uint8_t>(i);
+                    }
+                }
+                if (color == 0) {
+                    return false;
+                }
+                Style.Color = color;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Parses a FormatSpec.
+         * @return false unless all of Spec is a valid spec.
+         */
+        constexpr bool ParseFormatSpec(std::string_view Spec, FormatSpec& Result) {
+            Result = FormatSpec();
+            std::size_t i = 0;
+            auto isAlign = [](char c) { return c == '<' || c == '>' || c == '^'; };
+            auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+            if (Spec.size() >= 2 && isAlign(Spec[1])) {
+                Result.Fill = Spec[0];
+                Result.Align = Spec[1];
+                i = 2;
+            }
+            else if (!Spec.empty() && isAlign(Spec[0])) {
+                Result.Align = Spec[0];
+                i = 1;
+            }
+            if (i < Spec.size() && Spec[i] == '0') {
+                Result.ZeroPad = true;
+                i++;
+            }
+            for (int digits = 0; i < Spec.size() && isDigit(Spec[i]); i++) {
+                if (++digits > 3) {
+                    return false;
+                }
+                Result.Width = Result.Width * 10 + (Spec[i] - '0');
+            }
+            if (i < Spec.size() && Spec[i] == '.') {
+                Result.Precision = 0;
+                int digits = 0;
+                for (i++; i < Spec.size() && isDigit(Spec[i]); i++) {
+                    if (++digits > 2) {
+                        return false;
+                    }
+                    Result.Precision = Result.Precision * 10 + (Spec[i] - '0');
+                }
+                if (digits == 0) {
+                    return false;
+                }
+            }
+            if (i < Spec.size() && std::string_view("dxXocfegs").find(Spec[i]) != std::string_view::npos) {
+                Result.Type = Spec[i];
+                i++;
+            }
+            return i == Spec.size();
+        }
+
+        /**
+         * @brief Parses the inside of a "{...}" field into Run: an optional index, then after ':' style
+         * words and at most one FormatSpec, whose position Run.Begin/Length records.
+         * @return false if the field is not valid.
+         */
+        constexpr bool ParseMarkupField(std::string_view Template, std::size_t Begin, std::size_t End,
+            int& NextArgument, MarkupRun& Run)
+        {
+            std::string_view field = Template.substr(Begin, End - Begin);
+            std::size_t colon = field.find(':');
+            std::string_view index = field.substr(0, colon);
+            int argument = index.empty() ? NextArgument : 0;
+            if (index.size() > 4) {
+                return false;
+            }
+            for (char digit : index) {
+                if (digit < '0' || digit > '9') {
+                    return false;
+                }
+                argument = argument * 10 + (digit - '0');
+            }
+
+            if (colon != std::string_view::npos) {
+                bool hasSpec = false;
+                std::size_t word = colon + 1;
+                while (word <= field.size()) {
+                    std::size_t space = field.find(' ', word);
+                    std::size_t wordEnd = (space == std::string_view::npos) ? field.size() : space;
+                    std::string_view text = field.substr(word, wordEnd - word);
+                    FormatSpec spec;
+                    if (!text.empty() && !ApplyMarkupTag(text, Run.Style)) {
+                        if (hasSpec || !ParseFormatSpec(text, spec)) {
+                            return false;
+                        }
+                        hasSpec = true;
+                        Run.Begin = static_cast<std::uint32_t>(Begin + word);
+                        Run.Length = static_cast<std::uint32_t>(text.size());
+                    }
+                    word = wordEnd + 1;
+                }
+            }
+
+            if (index.empty()) {
+                NextArgument++;
+            }
+            Run.Argument = static_cast<std::int16_t>(argument);
+            return true;
+        }
+
+        [[noreturn]] void FormatError(const char* Message);
+
+        /**
+         * @brief Parses markup, calling Add(const MarkupRun&) for each run in order. See Markup for the syntax.
+         * Strict (format strings) reports malformed fields through FormatError() instead of keeping them as text.
+         * @return The number of arguments the template uses (the highest index plus one).
+         */
+        template <bool Strict = false, typename Adder>
+        constexpr int ParseMarkup(std::string_view Template, Adder&& Add) {
+            constexpr int MAX_DEPTH = 16;
+            MarkupStyle stack[MAX_DEPTH] = {};
+            int depth = 0;
+            MarkupStyle style;
+            int nextArgument = 0;
+            int arguments = 0;
+            std::size_t runBegin = 0;
+            std::size_t i = 0;
+
+            auto flush = [&](std::size_t End) {
+                if (End > runBegin) {
+                    MarkupRun run;
+                    run.Begin = static_cast<std::uint32_t>(runBegin);
+                    run.Length = static_cast<std::uint32_t>(End - runBegin);
+                    run.Style = style;
+                    Add(run);
+                }
+            };
+
+            while (i < Template.size()) {
+                char c = Template[i];
+                if (c != '\\' && c != '*' && c != '[' && c != '{' && c != '}') {
+                    i++;
+                    continue;
+                }
+                if (c == '\\' && i + 1 < Template.size()) {
+                    char next = Template[i + 1];
+                    if (next == '[' || next == ']' || next == '*' || next == '{' || next == '}' || next == '\\') {
+                        flush(i);
+                        runBegin = i + 1;
+                        i += 2;
+                        continue;
+                    }
+                }
+                if (c == '*' && i + 1 < Template.size() && Template[i + 1] == '*') {
+                    flush(i);
+                    style.Bold = !style.Bold;
+                    i += 2;
+                    runBegin = i;
+                    continue;
+                }
+                if (c == '[') {
+                    std::size_t close = Template.find(']', i + 1);
+                    if (close != std::string_view::npos) {
+                        std::string_view tag = Template.substr(i + 1, close - i - 1);
+                        MarkupStyle tagged = style;
+                        bool closing = !tag.empty() && tag[0] == '/';
+                        if ((closing && (tag.size() == 1 || ApplyMarkupTag(tag.substr(1), tagged)))
+                            || (!closing && ApplyMarkupTag(tag, tagged)))
+                        {
+                            flush(i);
+                            if (closing) {
+                                style = (depth > 0) ? stack[--depth] : MarkupStyle();
+                            }
+                            else {
+                                if (depth < MAX_DEPTH) {
+                                    stack[depth++] = style;
+                                }
+                                style = tagged;
+                            }
+                            i = close + 1;
+                            runBegin = i;
+                            continue;
+                        }
+                    }
+                }
+                if ((c == '{' || c == '}') && i + 1 < Template.size() && Template[i + 1] == c) {
+                    // "{{" and "}}" are literal braces.
+                    flush(i);
+                    runBegin = i + 1;
+                    i += 2;
+                    continue;
+                }
+                if (c == '{') {
+                    std::size_t close = Template.find('}', i + 1);
+                    MarkupRun run;
+                    run.Style = style;
+                    if (close != std::string_view::npos && ParseMarkupField(Template, i + 1, close, nextArgument, run)) {
+                        flush(i);
+                        Add(run);
+                        arguments = (run.Argument + 1 > arguments) ? run.Argument + 1 : arguments;
+                        i = close + 1;
+                        runBegin = i;
+                        continue;
+                    }
+                    if constexpr (Strict) {
+                        FormatError("invalid replacement field");
+                    }
+                }
+                if constexpr (Strict) {
+                    if (c == '}') {
+                        FormatError("unmatched '}' (write \"}}\")");
+                    }
+                }
+                i++;
+            }
+            flush(i);
+            return arguments;
+        }
+
+        /**
+         * @brief Returns how many runs ParseMarkup() produces for Template.
+         */
+        constexpr std::size_t CountMarkupRuns(std::string_view Template) {
+            std::size_t count = 0;
+            ParseMarkup(Template, [&count](const MarkupRun&) { count++; });
+            return count;
+        }
+
+        std::string RenderMarkupRuns(std::string_view Text, const MarkupRun* Runs, std::size_t Count,
+            std::initializer_list<std::string_view> Arguments);
+        std::string_view RenderMarkupRunsView(std::string_view Text, const MarkupRun* Runs, std::size_t Count,
+            std::initializer_list<std::string_view> Arguments);
+    } // namespace detail
+
+    /**
+     * @class Markup
+     * @brief A markup template compiled once into style runs, so rendering it only copies text and
+     * substitutes arguments.
+     *
+     * Syntax: [red]...[/] colors text (any Color name in lower case, e.g. light_blue), [b] or [bold] and
+     * [u] or [underline] set attributes, and tags combine ("[bold yellow]"). [/] or [/name] closes the
+     * innermost tag. **...** is bold. {} is the next argument and {N} the argument with index N; after
+     * a colon come style words and a FormatSpec, as in {:red} or {0:>8 bold}. A backslash makes the next
+     * [ ] * { } or backslash literal, as do "{{" and "}}"; brackets that are not a known tag stay as text,
+     * so "[INFO]" needs no escaping.
+     */
+    class Markup {
+    public:
+        explicit Markup(std::string_view Template);
+
+        std::string Render(std::initializer_list<std::string_view> Arguments = {}) const {
+            return detail::RenderMarkupRuns(text, runs.data(), runs.size(), Arguments);
+        }
+        std::string_view RenderView(std::initializer_list<std::string_view> Arguments = {}) const {
+            return detail::RenderMarkupRunsView(text, runs.data(), runs.size(), Arguments);
+        }
+
+        const std::string& Template() const { return text; }
+        const std::vector<MarkupRun>& Runs() const { return runs; }
+        int Arguments() const { return arguments; }
+
+    private:
+        std::string text;
+        std::vector<MarkupRun> runs;
+        int arguments;
+    };
+
+    /**
+     * @class StaticMarkup
+     * @brief A Markup compiled at compile time from a literal; see CONSOLETOOLS_MARKUP.
+     */
+    template <std::size_t Count>
+    class StaticMarkup {
+    public:
+        constexpr explicit StaticMarkup(std::string_view Template)
+            : text(Template),
+            runs{},
+            arguments(0)
+        {
+            std::size_t added = 0;
+            arguments = detail::ParseMarkup(Template, [this, &added](const MarkupRun& Run) { runs[added++] = Run; });
+        }
+
+        std::string Render(std::initializer_list<std::string_view> Arguments = {}) const {
+            return detail::RenderMarkupRuns(text, runs, Count, Arguments);
+        }
+        std::string_view RenderView(std::initializer_list<std::string_view> Arguments = {}) const {
+            return detail::RenderMarkupRunsView(text, runs, Count, Arguments);
+        }
+
+        constexpr std::string_view Template() const { return text; }
+        constexpr std::size_t Runs() const { return Count; }
+        constexpr int Arguments() const { return arguments; }
+
+    private:
+        std::string_view text;
+        MarkupRun runs[Count > 0 ? Count : 1];
+        int arguments;
+    };
+
+    std::string RenderMarkup(std::string_view Template, std::initializer_list<std::string_view> Arguments = {});
+    std::string_view RenderMarkupView(std::string_view Template, std::initializer_list<std::string_view> Arguments = {});
+
+    // Formatting
+
+    namespace detail {
+        template <typename T>
+        struct TypeIdentity {
+            using Type = T;
+        };
+
+        /**
+         * @brief Classifies a format argument: 'b'ool, 'c'har, 'i'nteger, 'f'loating point, 's'tring, or 0 if unsupported.
+         */
+        template <typename T>
+        constexpr char FormatKind() {
+            using Type = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr (std::is_same_v<Type, bool>) {
+                return 'b';
+            }
+            else if constexpr (std::is_same_v<Type, char>) {
+                return 'c';
+            }
+            else if constexpr (std::is_integral_v<Type>) {
+                return 'i';
+            }
+            else if constexpr (std::is_floating_point_v<Type>) {
+                return 'f';
+            }
+            else if constexpr (std::is_convertible_v<const Type&, std::string_view>) {
+                return 's';
+            }
+            else {
+                return 0;
+            }
+        }
+
+        /**
+         * @brief Returns whether Spec can format an argument of kind Kind (see FormatKind()).
+         */
+        constexpr bool FormatSpecAllows(char Kind, const FormatSpec& Spec) {
+            switch (Kind) {
+            case 'i':
+                return Spec.Precision < 0 && (Spec.Type == 0 || std::string_view("dxXoc").find(Spec.Type) != std::string_view::npos);
+            case 'f':
+                return Spec.Type == 0 || Spec.Type == 'f' || Spec.Type == 'e' || Spec.Type == 'g';
+            case 'c':
+                return Spec.Precision < 0 && !Spec.ZeroPad && (Spec.Type == 0 || Spec.Type == 'c');
+            default:
+                return Spec.Precision < 0 && !Spec.ZeroPad && (Spec.Type == 0 || Spec.Type == 's');
+            }
+        }
+
+        /**
+         * @struct FormatArgument
+         * @brief A format argument with its type erased, so the formatting loop is not a template.
+         */
+        struct FormatArgument {
+            const void* Value;
+            void (*Append)(std::string& Out, const void* Value, const FormatSpec& Spec);
+            char Kind;
+        };
+
+        void AppendFormattedInteger(std::string& Out, std::int64_t Value, const FormatSpec& Spec);
+        void AppendFormattedInteger(std::string& Out, std::uint64_t Value, const FormatSpec& Spec);
+        void AppendFormattedFloat(std::string& Out, double Value, const FormatSpec& Spec);
+
+        template <typename T>
+        void AppendFormatArgument(std::string& Out, const void* Value, const FormatSpec& Spec) {
+            const T& argument = *static_cast<const T*>(Value);
+            if constexpr (std::is_same_v<T, bool>) {
+                Out.append(argument ? "true" : "false");
+            }
+            else if constexpr (std::is_same_v<T, char>) {
+                Out.push_back(argument);
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                AppendFormattedInteger(Out, static_cast<std::int64_t>(argument), Spec);
+            }
+            else if constexpr (std::is_integral_v<T>) {
+                AppendFormattedInteger(Out, static_cast<std::uint64_t>(argument), Spec);
+            }
+            else if constexpr (std::is_floating_point_v<T>) {
+                AppendFormattedFloat(Out, static_cast<double>(argument), Spec);
+            }
+            else {
+                Out.append(std::string_view(argument));
+            }
+        }
+
+        template <typename T>
+        FormatArgument MakeFormatArgument(const T& Argument) {
+            static_assert(FormatKind<T>() != 0, "Unsupported format argument type");
+            return FormatArgument{ &Argument, &AppendFormatArgument<T>, FormatKind<T>() };
+        }
+
+        /**
+         * @struct FormatRun
+         * @brief A run of a compiled format string, with its FormatSpec already parsed for argument runs.
+         */
+        struct FormatRun {
+            MarkupRun Run;
+            FormatSpec Spec;
+        };
+
+        /**
+         * @struct CompiledFormat
+         * @brief A format string as BasicFormatString compiled it. Runs is null when the string had
+         * more runs than fit, in which case Text is parsed again while formatting.
+         */
+        struct CompiledFormat {
+            std::string_view Text;
+            const FormatRun* Runs;
+            std::size_t Count;
+        };
+
+        void VFormatTo(std::string& Out, const CompiledFormat& Format, const FormatArgument* Arguments, std::size_t Count);
+        std::string_view VFormatView(const CompiledFormat& Format, const FormatArgument* Arguments, std::size_t Count);
+        void VPrintFormat(const CompiledFormat& Format, const FormatArgument* Arguments, std::size_t Count);
+    } // namespace detail
+
+    /**
+     * @class BasicFormatString
+     * @brief A format string checked against its argument types and compiled into runs when it is
+     * constructed, which happens at compile time for literals in C++20, so formatting only walks the
+     * runs. Strings with more than RunCapacity runs are still checked, but parsed again when formatted.
+     * Use it through FormatString.
+     */
+    template <typename... Args>
+    class BasicFormatString {
+    public:
+        static constexpr std::size_t RunCapacity = 16;
+
+        template <typename T, typename = std::enable_if_t<std::is_convertible_v<const T&, std::string_view>>>
+        CONSOLETOOLS_CONSTEVAL BasicFormatString(const T& Text)
+            : text(Text),
+            runs{},
+            runCount(0)
+        {
+            constexpr char kinds[] = { detail::FormatKind<Args>()..., 0 };
+            std::string_view format = text;
+            detail::ParseMarkup<true>(format, [this, format, &kinds](const MarkupRun& Run) {
+                FormatSpec spec;
+                if (Run.Argument >= 0) {
+                    if (static_cast<std::size_t>(Run.Argument) >= sizeof...(Args)) {
+                        detail::FormatError("format string refers to an argument that was not passed");
+                    }
+                    detail::ParseFormatSpec(format.substr(Run.Begin, Run.Length), spec);
+                    if (!detail::FormatSpecAllows(kinds[Run.Argument], spec)) {
+                        detail::FormatError("format spec does not suit the argument's type");
+                    }
+                }
+                if (runCount < RunCapacity) {
+                    runs[runCount] = detail::FormatRun{ Run, spec };
+                }
+                runCount++;
+            });
+        }
+
+        constexpr std::string_view Get() const { return text; }
+
+        detail::CompiledFormat Compiled() const {
+            return detail::CompiledFormat{ text, (runCount <= RunCapacity) ? runs : nullptr, runCount };
+        }
+
+    private:
+        std::string_view text;
+        detail::FormatRun runs[RunCapacity];
+        std::size_t runCount;
+    };
+
+    /**
+     * @brief Format string for the given argument types. Only the arguments are used to deduce them.
+     */
+    template <typename... Args>
+    using FormatString = BasicFormatString<typename detail::TypeIdentity<std::remove_cv_t<std::remove_reference_t<Args>>>::Type...>;
+
+    /**
+     * @brief Formats Arguments into a format string: markup (see Markup) whose {} fields take values of
+     * any arithmetic or string type, with an optional FormatSpec and style, e.g.
+     * Format("[bold]{}[/] took {:>6.1f red} ms", name, elapsed). Malformed format strings and specs that
+     * do not suit their argument fail to compile (C++20) or throw std::invalid_argument (C++17).
+     * @return The formatted text.
+     */
+    template <typename... Args>
+    std::string Format(FormatString<Args...> Text, const Args&... Arguments) {
+        std::string formatted;
+        detail::FormatArgument erased[] = { detail::MakeFormatArgument(Arguments)..., detail::FormatArgument{} };
+        detail::VFormatTo(formatted, Text.Compiled(), erased, sizeof...(Args));
+        return formatted;
+    }
+
+    /**
+     * @brief Format() appended straight to Out, so a reused buffer formats without allocating.
+     * @return Out.
+     */
+    template <typename... Args>
+    std::string& FormatTo(std::string& Out, FormatString<Args...> Text, const Args&... Arguments) {
+        detail::FormatArgument erased[] = { detail::MakeFormatArgument(Arguments)..., detail::FormatArgument{} };
+        detail::VFormatTo(Out, Text.Compiled(), erased, sizeof...(Args));
+        return Out;
+    }
+
+    /**
+     * @brief Format() into this thread's view buffer.
+     * @return A view valid until the next *View call on this thread.
+     */
+    template <typename... Args>
+    std::string_view FormatView(FormatString<Args...> Text, const Args&... Arguments) {
+        detail::FormatArgument erased[] = { detail::MakeFormatArgument(Arguments)..., detail::FormatArgument{} };
+        return detail::VFormatView(Text.Compiled(), erased, sizeof...(Args));
+    }
+
+    /**
+     * @brief Format() written to the output sink (see Print()) through a per-thread buffer, without flushing.
+     */
+    template <typename... Args>
+    void PrintFormat(FormatString<Args...> Text, const Args&... Arguments) {
+        detail::FormatArgument erased[] = { detail::MakeFormatArgument(Arguments)..., detail::FormatArgument{} };
+        detail::VPrintFormat(Text.Compiled(), erased, sizeof...(Args));
+    }
+
+    // Batch rendering
+
+    /**
+     * @struct ProgressBarStyle
+     * @brief The parameters of AdvancedProgressBar() that are shared by every bar of a batch.
+     * Colors left empty emit no color code.
+     */
+    struct ProgressBarStyle {
+        int BarWidth = 40;
+        std::string_view SuffixText;
+        std::string_view FillChar = "#";
+        std::string_view UnfilledChar = "-";
+        std::string_view FillColor;
+        std::string_view UnfilledColor;
+        std::string_view TextColor;
+        std::string_view PrefixColor;
+        std::string_view SuffixColor;
+        std::string_view BracketColor;
+        bool ShowPercentage = true;
+        bool ShowBrackets = true;
+        bool ResetColorOnCompletion = true;
+    };
+
+    std::string AdvancedProgressBars(const ProgressBarStyle& Style,
+        const int* CurrentPercentages,
+        const int* MaxPercentages,
+        const std::string_view* Labels,
+        std::size_t Count);
+
+    std::string_view AdvancedProgressBarsView(const ProgressBarStyle& Style,
+        const int* CurrentPercentages,
+        const int* MaxPercentages,
+        const std::string_view* Labels,
+        std::size_t Count);
+
+    // Widgets
+
+    /**
+     * @struct HeaderStyle
+     * @brief The parameters of AdvancedHeader() other than its text. Header() is the case where both
+     * sides use the same character, count and color.
+     */
+    struct HeaderStyle {
+        std::string_view LeftLineCharacter = "=";
+        int LeftLineCharacterCount = 10;
+        std::string_view RightLineCharacter = "=";
+        int RightLineCharacterCount = 10;
+        std::string_view SpacingCharacter = " ";
+        std::string_view LeftLineColor;
+        std::string_view RightLineColor;
+        std::string_view HeaderTextColor;
+        std::string_view SpacingCharacterColor;
+        bool ResetColorOnEnd = true;
+    };
+
+    /**
+     * @struct NotificationStyle
+     * @brief The parameters of Notification() other than its text.
+     */
+    struct NotificationStyle {
+        std::string_view LeftBorderCharacter = "[";
+        std::string_view InsideCharacter = "!";
+        std::string_view RightBorderCharacter = "]";
+        std::string_view NotificationTypeText = "INFO";
+        std::string_view BorderCharacterColor;
+        std::string_view InsideCharacterColor;
+        std::string_view NotificationTextColor;
+    };
+
+    /**
+     * @class ProgressBarWidget
+     * @brief An AdvancedProgressBar() whose style is fixed when it is constructed. Everything that does
+     * not depend on the progress is laid out once, so a render copies a few precomputed pieces and
+     * writes the percentage. The output is the same as AdvancedProgressBar() with Label as its PrefixText.
+     *
+     * The style is copied, so it may go out of scope. A widget that uses FILL_AVAILABLE_WIDTH follows
+     * the terminal width and may grow its buffers while rendering, so use one widget per thread.
+     */
+    class ProgressBarWidget {
+    public:
+        explicit ProgressBarWidget(const ProgressBarStyle& Style, std::string_view Label = {});
+
+        std::string Render(int CurrentPercentage, int MaxPercentage);
+        std::string_view RenderView(int CurrentPercentage, int MaxPercentage);
+        std::string& RenderTo(std::string& Out, int CurrentPercentage, int MaxPercentage);
+
+    private:
+        std::string head;
+        std::string unfilledColor;
+        std::string middle;
+        std::string tail;
+        std::string fillRun;
+        std::string unfilledRun;
+        std::string fillChar;
+        std::string unfilledChar;
+        int barWidth;
+        int fixedWidth;
+        int unitWidth;
+        bool showPercentage;
+    };
+
+    /**
+     * @class HeaderWidget
+     * @brief An AdvancedHeader() whose style is fixed when it is constructed, so a render copies the
+     * precomputed lines and colors around the text. The style is copied; see ProgressBarWidget for
+     * FILL_AVAILABLE_WIDTH.
+     */
+    class HeaderWidget {
+    public:
+        explicit HeaderWidget(const HeaderStyle& Style);
+
+        std::string Render(std::string_view HeaderText);
+        std::string_view RenderView(std::string_view HeaderText);
+        std::string& RenderTo(std::string& Out, std::string_view HeaderText);
+
+    private:
+        std::string leftLineColor;
+        std::string leftRun;
+        std::string beforeText;
+        std::string afterText;
+        std::string rightRun;
+        std::string end;
+        std::string leftLineCharacter;
+        std::string rightLineCharacter;
+        int leftCount;
+        int rightCount;
+        int leftWidth;
+        int rightWidth;
+        int spacingWidth;
+    };
+
+    /**
+     * @class NotificationWidget
+     * @brief A Notification() whose border, type and colors are fixed when it is constructed, so a render
+     * is the precomputed prefix, the text and a reset.
+     */
+    class NotificationWidget {
+    public:
+        explicit NotificationWidget(const NotificationStyle& Style);
+
+        std::string Render(std::string_view NotificationText) const;
+        std::string_view RenderView(std::string_view NotificationText) const;
+        std::string& RenderTo(std::string& Out, std::string_view NotificationText) const;
+
+    private:
+        std::string prefix;
+    };
+
 } // namespace ConsoleTools
 
-#endif // CONSOLE_TOOLS_H
\ No newline at end of file
+/**
+ * @brief Logs through DefaultLogger(). Levels below CONSOLETOOLS_MIN_LOG_LEVEL compile to nothing,
+ * and the arguments are not evaluated unless the level is enabled at runtime.
+ */
+#define CONSOLETOOLS_LOG(Level, ...) \
+    do { \
+        if constexpr (static_cast<int>(Level) >= CONSOLETOOLS_MIN_LOG_LEVEL) { \
+            if (::ConsoleTools::DefaultLogger().IsEnabled(Level)) { \
+                ::ConsoleTools::DefaultLogger().Log(Level, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define CONSOLETOOLS_LOG_TRACE(...) CONSOLETOOLS_LOG(::ConsoleTools::LogLevel::Trace, __VA_ARGS__)
+#define CONSOLETOOLS_LOG_DEBUG(...) CONSOLETOOLS_LOG(::ConsoleTools::LogLevel::Debug, __VA_ARGS__)
+#define CONSOLETOOLS_LOG_INFO(...) CONSOLETOOLS_LOG(::ConsoleTools::LogLevel::Info, __VA_ARGS__)
+#define CONSOLETOOLS_LOG_WARNING(...) CONSOLETOOLS_LOG(::ConsoleTools::LogLevel::Warning, __VA_ARGS__)
+#define CONSOLETOOLS_LOG_ERROR(...) CONSOLETOOLS_LOG(::ConsoleTools::LogLevel::Error, __VA_ARGS__)
+#define CONSOLETOOLS_LOG_FATAL(...) CONSOLETOOLS_LOG(::ConsoleTools::LogLevel::Fatal, __VA_ARGS__)
+
+/**
+ * @brief Compiles a markup string literal at compile time and yields a StaticMarkup for it, e.g.
+ * CONSOLETOOLS_MARKUP("[red]{}[/] failed").Render({ name }). Rendering then does no parsing at all.
+ */
+#define CONSOLETOOLS_MARKUP(Literal) \
+    ([]() { \
+        constexpr ::ConsoleTools::StaticMarkup<::ConsoleTools::detail::CountMarkupRuns(Literal)> consoleToolsMarkup(Literal); \
+        return consoleToolsMarkup; \
+    }())
+
+#ifdef CONSOLETOOLS_HEADER_ONLY
+#include "ConsoleTools.cpp"
+#endif
+
+#endif // CONSOLE_TOOLS_H
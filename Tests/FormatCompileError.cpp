@@ -0,0 +1,12 @@
+/**
+ * @file FormatCompileError.cpp
+ * @brief Must NOT compile in C++20: "{:.2f}" does not suit a string argument, and format strings
+ * are checked at compile time. The ConsoleToolsFormatCompileError test builds it and expects the
+ * error to come from the format check.
+ */
+
+#include "ConsoleTools.h"
+
+int main() {
+    return static_cast<int>(ConsoleTools::Format("{:.2f}", "text").size());
+}
@@ -0,0 +1,1053 @@
+/**
+ * @file Tests.cpp
+ * @brief Checks the ConsoleTools builders and widgets without a terminal.
+ *
+ * Output goes to a CaptureSink and is replayed into a VirtualTerminal, and animations run on a
+ * VirtualClock, so every run sees the same bytes. Pass a test name to run only that test.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConsoleTools.h"
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace ConsoleTools;
+
+namespace {
+
+    int failures = 0;
+
+    /**
+     * @brief Makes escape sequences and other control bytes readable in failure messages.
+     */
+    std::string Printable(std::string_view Text) {
+        std::string result;
+        for (char character : Text) {
+            if (character == '\033') {
+                result.append("\\e");
+            }
+            else if (character == '\n') {
+                result.append("\\n");
+            }
+            else if (static_cast<unsigned char>(character) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\x%02x", static_cast<unsigned char>(character));
+                result.append(code);
+            }
+            else {
+                result.push_back(character);
+            }
+        }
+        return result;
+    }
+
+    bool Check(bool Condition, const char* Expression, const char* File, int Line) {
+        if (!Condition) {
+            failures++;
+            std::printf("%s:%d: CHECK(%s) failed\n", File, Line, Expression);
+        }
+        return Condition;
+    }
+
+    void CheckEqual(std::string_view Actual, std::string_view Expected, const char* Expression, const char* File, int Line) {
+        if (Actual != Expected) {
+            failures++;
+            std::printf("%s:%d: %s\n    got      \"%s\"\n    expected \"%s\"\n", File, Line, Expression,
+                Printable(Actual).c_str(), Printable(Expected).c_str());
+        }
+    }
+
+    /**
+     * @brief Polls Condition in real time; used while a background thread follows the VirtualClock.
+     */
+    template <typename Predicate>
+    bool WaitFor(Predicate Condition) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!Condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Strips trailing spaces, the way VirtualTerminal::RowText() reports a row.
+     */
+    std::string TrimRight(std::string Text) {
+        while (!Text.empty() && Text.back() == ' ') {
+            Text.pop_back();
+        }
+        return Text;
+    }
+
+} // namespace
+
+#define CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+#define CHECK_EQUAL(Actual, Expected) CheckEqual((Actual), (Expected), #Actual, __FILE__, __LINE__)
+
+namespace {
+
+    const char* const testColors[] = { "", "\033[32m", "\033[1;34m" };
+    const char* const testCharacters[] = { "#", "-", "█", "", "ab" };
+    const char* const testTexts[] = { "", "Loading", "世界 x", "\033[31mred\033[0m" };
+
+    template <typename T, std::size_t N>
+    const T& Pick(std::mt19937& Random, const T (&Values)[N]) {
+        return Values[Random() % N];
+    }
+
+    void TestWidgetsMatchBuilders() {
+        std::mt19937 random(7);
+        for (int trial = 0; trial < 500; trial++) {
+            ProgressBarStyle style;
+            const int widths[] = { 0, 1, 13, 40, -3, FILL_AVAILABLE_WIDTH };
+            style.BarWidth = Pick(random, widths);
+            style.SuffixText = Pick(random, testTexts);
+            style.FillChar = Pick(random, testCharacters);
+            style.UnfilledChar = Pick(random, testCharacters);
+            style.FillColor = Pick(random, testColors);
+            style.UnfilledColor = Pick(random, testColors);
+            style.TextColor = Pick(random, testColors);
+            style.PrefixColor = Pick(random, testColors);
+            style.SuffixColor = Pick(random, testColors);
+            style.BracketColor = Pick(random, testColors);
+            style.ShowPercentage = random() & 1;
+            style.ShowBrackets = random() & 1;
+            style.ResetColorOnCompletion = random() & 1;
+            std::string label = Pick(random, testTexts);
+
+            ProgressBarWidget bar(style, label);
+            for (int step = 0; step < 4; step++) {
+                const int maximums[] = { 100, 7, 0, -5, 1 };
+                int maximum = Pick(random, maximums);
+                int current = static_cast<int>(random() % 130) - 10;
+                std::string expected = AdvancedProgressBar(current, maximum, style.BarWidth, label,
+                    std::string(style.SuffixText), std::string(style.FillChar), std::string(style.UnfilledChar),
+                    std::string(style.FillColor), std::string(style.UnfilledColor), std::string(style.TextColor),
+                    std::string(style.PrefixColor), std::string(style.SuffixColor), std::string(style.BracketColor),
+                    style.ShowPercentage, style.ShowBrackets, style.ResetColorOnCompletion);
+                CHECK_EQUAL(bar.Render(current, maximum), expected);
+                CHECK_EQUAL(bar.RenderView(current, maximum), expected);
+                std::string appended = "x";
+                bar.RenderTo(appended, current, maximum);
+                CHECK_EQUAL(appended, "x" + expected);
+            }
+
+            HeaderStyle headerStyle;
+            const int counts[] = { 0, 3, 10, -2, FILL_AVAILABLE_WIDTH };
+            headerStyle.LeftLineCharacter = Pick(random, testCharacters);
+            headerStyle.RightLineCharacter = Pick(random, testCharacters);
+            headerStyle.LeftLineCharacterCount = Pick(random, counts);
+            headerStyle.RightLineCharacterCount = Pick(random, counts);
+            headerStyle.SpacingCharacter = Pick(random, testCharacters);
+            headerStyle.LeftLineColor = Pick(random, testColors);
+            headerStyle.RightLineColor = Pick(random, testColors);
+            headerStyle.HeaderTextColor = Pick(random, testColors);
+            headerStyle.SpacingCharacterColor = Pick(random, testColors);
+            headerStyle.ResetColorOnEnd = random() & 1;
+
+            HeaderWidget header(headerStyle);
+            std::string text = Pick(random, testTexts);
+            std::string expected = AdvancedHeader(std::string(headerStyle.LeftLineCharacter),
+                headerStyle.LeftLineCharacterCount, std::string(headerStyle.RightLineCharacter),
+                headerStyle.RightLineCharacterCount, text, std::string(headerStyle.SpacingCharacter),
+                std::string(headerStyle.LeftLineColor), std::string(headerStyle.RightLineColor),
+                std::string(headerStyle.HeaderTextColor), std::string(headerStyle.SpacingCharacterColor),
+                headerStyle.ResetColorOnEnd);
+            CHECK_EQUAL(header.Render(text), expected);
+            CHECK_EQUAL(header.RenderView(text), expected);
+        }
+    }
+
+    void TestBatchMatchesSingleBars() {
+        std::mt19937 random(11);
+        for (int trial = 0; trial < 200; trial++) {
+            ProgressBarStyle style;
+            const int widths[] = { 0, 1, 7, 40, 100, FILL_AVAILABLE_WIDTH, -3 };
+            style.BarWidth = Pick(random, widths);
+            style.SuffixText = (random() & 1) ? "done" : "";
+            style.FillChar = (random() & 1) ? "█" : "#";
+            style.UnfilledChar = (random() & 1) ? "░" : "-";
+            style.FillColor = Color::GREEN;
+            style.UnfilledColor = (random() & 1) ? Color::GRAY : "";
+            style.TextColor = Color::WHITE;
+            style.PrefixColor = Color::YELLOW;
+            style.SuffixColor = Color::LIGHT_BLUE;
+            style.BracketColor = Color::RED;
+            style.ShowPercentage = random() & 1;
+            style.ShowBrackets = random() & 1;
+            style.ResetColorOnCompletion = random() & 1;
+
+            int rows = static_cast<int>(random() % 30);
+            std::vector<int> current(static_cast<std::size_t>(rows));
+            std::vector<int> maximum(static_cast<std::size_t>(rows));
+            std::vector<std::string> labels(static_cast<std::size_t>(rows));
+            std::vector<std::string_view> labelViews(static_cast<std::size_t>(rows));
+            for (std::size_t i = 0; i < labels.size(); i++) {
+                maximum[i] = (random() % 7 == 0) ? static_cast<int>(random() % 5) - 2 : static_cast<int>(random() % 1000);
+                current[i] = static_cast<int>(random() % 1200) - 100;
+                labels[i] = (random() % 3 == 0) ? "" : "task-" + std::to_string(i) + " ";
+                labelViews[i] = labels[i];
+            }
+            bool useLabels = random() % 4 != 0;
+
+            std::string expected;
+            for (std::size_t i = 0; i < labels.size(); i++) {
+                if (i > 0) {
+                    expected.push_back('\n');
+                }
+                expected += AdvancedProgressBar(current[i], maximum[i], style.BarWidth, useLabels ? labels[i] : "",
+                    std::string(style.SuffixText), std::string(style.FillChar), std::string(style.UnfilledChar),
+                    std::string(style.FillColor), std::string(style.UnfilledColor), std::string(style.TextColor),
+                    std::string(style.PrefixColor), std::string(style.SuffixColor), std::string(style.BracketColor),
+                    style.ShowPercentage, style.ShowBrackets, style.ResetColorOnCompletion);
+            }
+            const std::string_view* labelData = useLabels ? labelViews.data() : nullptr;
+            CHECK_EQUAL(AdvancedProgressBars(style, current.data(), maximum.data(), labelData, rows), expected);
+            CHECK_EQUAL(AdvancedProgressBarsView(style, current.data(), maximum.data(), labelData, rows), expected);
+        }
+    }
+
+    /**
+     * @brief Removes escape sequences, leaving the visible text.
+     */
+    std::string StripEscapes(std::string_view Text) {
+        std::string result;
+        for (std::size_t i = 0; i < Text.size();) {
+            if (Text[i] == '\033') {
+                i += 2;
+                while (i < Text.size() && !(Text[i] >= 0x40 && Text[i] <= 0x7E)) {
+                    i++;
+                }
+                i++;
+            }
+            else {
+                result.push_back(Text[i++]);
+            }
+        }
+        return result;
+    }
+
+    void TestWrapTextStaysWithinWidth() {
+        const std::string text = "The quick brown fox jumps over the lazy dog and keeps running through the "
+            "\033[31mred field of\033[0m poppies until 漢字漢字漢字 the end. "
+            "Supercalifragilisticexpialidocious-and-then-some word here.\n\nSecond paragraph   with  spaces.";
+
+        std::string words;
+        for (char character : StripEscapes(text)) {
+            if (character != ' ' && character != '\n') {
+                words.push_back(character);
+            }
+        }
+
+        for (WrapMode mode : { WrapMode::Greedy, WrapMode::Balanced }) {
+            for (int width : { 5, 12, 20, 33, 80 }) {
+                for (int indent : { 0, 2, 4 }) {
+                    if (width - indent < 2) {
+                        continue;
+                    }
+                    std::string wrapped = WrapText(text, width, indent, mode);
+                    std::istringstream lines(wrapped);
+                    std::string line;
+                    for (int row = 0; std::getline(lines, line); row++) {
+                        CHECK(VisibleWidth(line) <= width);
+                        if (row > 0 && !line.empty()) {
+                            CHECK(line.compare(0, static_cast<std::size_t>(indent), std::string(static_cast<std::size_t>(indent), ' ')) == 0);
+                        }
+                    }
+
+                    std::string wrappedWords;
+                    for (char character : StripEscapes(wrapped)) {
+                        if (character != ' ' && character != '\n') {
+                            wrappedWords.push_back(character);
+                        }
+                    }
+                    CHECK_EQUAL(wrappedWords, words);
+                }
+            }
+        }
+
+        CHECK_EQUAL(WrapText("", 10), "");
+        CHECK_EQUAL(WrapText("a\n", 10), "a\n");
+        CHECK_EQUAL(WrapTextView("aa bb cc", 5), "aa bb\ncc");
+    }
+
+    void TestSeriesBufferMinMaxAfterEviction() {
+        std::mt19937 random(1);
+        for (std::size_t capacity : { 1u, 2u, 7u, 64u }) {
+            SeriesBuffer buffer(capacity);
+            std::deque<double> reference;
+            for (int i = 0; i < 3000; i++) {
+                double value = static_cast<double>(random() % 1000) - 300.0;
+                buffer.Push(value);
+                reference.push_back(value);
+                if (reference.size() > capacity) {
+                    reference.pop_front();
+                }
+                CHECK(buffer.Size() == reference.size());
+                CHECK(buffer.Min() == *std::min_element(reference.begin(), reference.end()));
+                CHECK(buffer.Max() == *std::max_element(reference.begin(), reference.end()));
+                CHECK(buffer[0] == reference.front());
+                CHECK(buffer.Latest() == value);
+            }
+        }
+
+        // A falling run keeps the oldest maximum until it is evicted.
+        SeriesBuffer falling(3);
+        for (double value : { 9.0, 8.0, 7.0, 6.0 }) {
+            falling.Push(value);
+        }
+        CHECK(falling.Max() == 8.0);
+        CHECK(falling.Min() == 6.0);
+
+        // Non-finite samples would leave the charts without a scale, so they are dropped.
+        SeriesBuffer finite(4);
+        finite.Push(1.0);
+        finite.Push(std::numeric_limits<double>::infinity());
+        finite.Push(-std::numeric_limits<double>::infinity());
+        finite.Push(std::numeric_limits<double>::quiet_NaN());
+        finite.Push(3.0);
+        CHECK(finite.Size() == 2);
+        CHECK(finite.Max() == 3.0);
+        CHECK(finite.Min() == 1.0);
+        CHECK_EQUAL(Sparkline(finite, 4, ""), std::string("  ") + "\xE2\x96\x81\xE2\x96\x88" + Color::RESET);
+        CHECK(!MiniBarChart(finite, 4, 2).empty());
+    }
+
+    void TestHistogramBucketBounds() {
+        using Histogram = LogLinearHistogram;
+        for (int index = 0; index < Histogram::BucketCount; index++) {
+            std::uint64_t lower = Histogram::BucketLowerBound(index);
+            std::uint64_t upper = Histogram::BucketUpperBound(index);
+            CHECK(lower < upper);
+            CHECK(Histogram::BucketIndex(lower) == index);
+            CHECK(Histogram::BucketIndex(upper - 1) == index);
+            if (index + 1 < Histogram::BucketCount) {
+                CHECK(upper == Histogram::BucketLowerBound(index + 1));
+            }
+            if (index >= Histogram::SubBuckets) {
+                // Every bucket is at most 1/SubBuckets of its lower bound wide.
+                CHECK((upper - lower) * Histogram::SubBuckets <= lower);
+            }
+        }
+        CHECK(Histogram::BucketIndex(~std::uint64_t{ 0 }) == Histogram::BucketCount - 1);
+
+        Histogram histogram;
+        for (std::uint64_t value = 1; value <= 1000; value++) {
+            histogram.Record(value);
+        }
+        CHECK(histogram.Count() == 1000);
+        CHECK(histogram.Min() == 1);
+        CHECK(histogram.Max() == 1000);
+        std::uint64_t median = histogram.Percentile(50.0);
+        CHECK(median >= 500 && median <= 500 + 500 / Histogram::SubBuckets);
+        CHECK(histogram.Percentile(100.0) == 1000);
+
+        // Rebuilt from bucket counts, the extremes are only known once SetRange() supplies them.
+        Histogram rebuilt;
+        for (int index = 0; index < Histogram::BucketCount; index++) {
+            rebuilt.RecordBucket(index, histogram.BucketValue(index));
+        }
+        CHECK(rebuilt.Count() == histogram.Count());
+        rebuilt.SetRange(histogram.Min(), histogram.Max());
+        CHECK(rebuilt.Max() == 1000);
+        CHECK(rebuilt.Percentile(99.9) <= 1000);
+    }
+
+    void TestConcurrentHistogramIntervals() {
+        constexpr int THREADS = 4;
+        ConcurrentHistogram histogram;
+        std::atomic<bool> stop{ false };
+        std::uint64_t recorded[THREADS] = {};
+        std::vector<std::thread> writers;
+        for (int t = 0; t < THREADS; t++) {
+            writers.emplace_back([&histogram, &stop, &recorded, t] {
+                while (!stop) {
+                    histogram.Record(std::uint64_t{ 1000 } << t);
+                    recorded[t]++;
+                }
+            });
+        }
+
+        // Intervals taken while the writers run lose and repeat no sample.
+        LogLinearHistogram total;
+        for (int interval = 0; interval < 200; interval++) {
+            total.Merge(histogram.TakeInterval());
+        }
+        stop = true;
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        total.Merge(histogram.TakeInterval());
+        std::uint64_t expected = 0;
+        for (int t = 0; t < THREADS; t++) {
+            expected += recorded[t];
+            CHECK(total.BucketValue(LogLinearHistogram::BucketIndex(std::uint64_t{ 1000 } << t)) == recorded[t]);
+        }
+        CHECK(total.Count() == expected);
+        CHECK(histogram.Snapshot().Count() == 0);
+    }
+
+    /**
+     * @struct SlowFlushSink
+     * @brief Sink whose Flush() takes at least 2.1 ms: just past a histogram bucket's lower bound
+     * (2^21 ns), so a maximum taken from the buckets would fall short of it.
+     */
+    struct SlowFlushSink : OutputSink {
+        void Write(std::string_view) override {}
+        void Flush() override { std::this_thread::sleep_for(std::chrono::microseconds(2100)); }
+    };
+
+    void TestInstrumentationSnapshot() {
+        ResetInstrumentation();
+        if (!INSTRUMENTATION_ENABLED) {
+            CHECK(TakeInstrumentationSnapshot().empty());
+            CHECK(DumpInstrumentation().find("disabled") != std::string::npos);
+            return;
+        }
+
+        // The slow flush runs on a thread that exits, so its extremes have to survive being retired.
+        std::chrono::nanoseconds slowest{};
+        std::thread slow([&slowest] {
+            SlowFlushSink sink;
+            SetOutputSink(&sink);
+            auto start = std::chrono::steady_clock::now();
+            FlushOutput();
+            slowest = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            SetOutputSink(nullptr);
+        });
+        slow.join();
+        CaptureSink capture;
+        SetOutputSink(&capture);
+        for (int i = 0; i < 100; i++) {
+            FlushOutput();
+        }
+        SetOutputSink(nullptr);
+
+        // Min and max are the exact extremes, not bucket bounds.
+        std::vector<MetricSnapshot> snapshot = TakeInstrumentationSnapshot();
+        const MetricSnapshot& flush = snapshot[static_cast<std::size_t>(Metric::Flush)];
+        CHECK(flush.Calls == 101);
+        CHECK(flush.Latency.Count() == 101);
+        CHECK(flush.Latency.Max() >= 2100000);
+        CHECK(flush.Latency.Max() <= static_cast<std::uint64_t>(slowest.count()));
+        CHECK(flush.Latency.Min() <= flush.Latency.Percentile(50.0));
+        CHECK(flush.Latency.Percentile(100.0) == flush.Latency.Max());
+        CHECK(DumpInstrumentation().find(MetricName(Metric::Flush)) != std::string::npos);
+
+        ResetInstrumentation();
+        CHECK(TakeInstrumentationSnapshot()[static_cast<std::size_t>(Metric::Flush)].Calls == 0);
+    }
+
+    void TestLayoutArrange() {
+        Layout layout(LayoutDirection::Column);
+        int top = layout.Add(Layout::ROOT, LayoutSize::Fixed(3));
+        int middle = layout.Add(Layout::ROOT, LayoutSize::Flex(), LayoutDirection::Row);
+        int bottom = layout.Add(Layout::ROOT, LayoutSize::Percent(25));
+        int left = layout.Add(middle, LayoutSize::Flex(1));
+        int right = layout.Add(middle, LayoutSize::Flex(2).WithMin(30));
+        layout.SetBorder(top, Borders::ROUNDED, "Title");
+        layout.SetBorder(left, Borders::LIGHT);
+
+        CHECK(layout.Resize(40, 20));
+        CHECK(!layout.Resize(40, 20));
+
+        auto same = [](const Rect& Region, int Row, int Column, int Width, int Height) {
+            return Region.Row == Row && Region.Column == Column && Region.Width == Width && Region.Height == Height;
+        };
+        CHECK(same(layout.Bounds(top), 0, 0, 40, 3));
+        CHECK(same(layout.Content(top), 1, 1, 38, 1));
+        CHECK(same(layout.Bounds(bottom), 15, 0, 40, 5));
+        CHECK(same(layout.Bounds(middle), 3, 0, 40, 12));
+        CHECK(same(layout.Bounds(right), 3, 10, 30, 12));   // Min wins over the 1:2 share
+        CHECK(same(layout.Bounds(left), 3, 0, 10, 12));
+        CHECK(same(layout.Content(left), 4, 1, 8, 10));
+
+        CHECK(layout.Resize(90, 20));
+        CHECK(same(layout.Bounds(left), 3, 0, 30, 12));
+        CHECK(same(layout.Bounds(right), 3, 30, 60, 12));
+
+        // Degenerate sizes must not produce negative regions.
+        layout.Resize(3, 2);
+        for (int region = 0; region < layout.Regions(); region++) {
+            CHECK(layout.Bounds(region).Width >= 0 && layout.Bounds(region).Height >= 0);
+            CHECK(layout.Content(region).Width >= 0 && layout.Content(region).Height >= 0);
+        }
+    }
+
+    void TestFrameBufferDiff() {
+        FrameBuffer frame(20, 4);
+        frame.Write(Rect{ 0, 0, 20, 1 }, "\033[1;31mbold red\033[0m plain");
+        frame.Write(Rect{ 1, 2, 10, 1 }, "wide 漢字");
+        std::string first(frame.Render());
+
+        VirtualTerminal terminal(20, 4);
+        terminal.Feed(first);
+        for (int row = 0; row < 4; row++) {
+            CHECK_EQUAL(terminal.RowText(row), TrimRight(frame.RowText(row)));
+        }
+        CHECK(terminal.At(0, 0).Bold);
+        CHECK_EQUAL(terminal.At(0, 0).Foreground, Color::RED);
+
+        // Nothing changed, nothing to send.
+        CHECK(frame.Render().empty());
+
+        // One changed cell is sent on its own, addressed absolutely.
+        frame.Write(Rect{ 2, 5, 1, 1 }, "X");
+        std::string diff(frame.Render());
+        CHECK(diff.size() < first.size());
+        CHECK(diff.find("\033[3;6H") != std::string::npos);
+        CHECK(diff.find("plain") == std::string::npos);
+        terminal.Feed(diff);
+        CHECK_EQUAL(terminal.RowText(2), "     X");
+
+        // Overwriting half of a wide character blanks the other half.
+        frame.Write(Rect{ 1, 8, 1, 1 }, "Y");
+        terminal.Feed(frame.Render());
+        CHECK_EQUAL(terminal.RowText(1), TrimRight(frame.RowText(1)));
+
+        frame.Invalidate();
+        CHECK(!frame.Render().empty());
+    }
+
+    void TestVirtualTerminalCombiningMarks() {
+        // A combining acute accent (U+0301) after a wide character belongs to the character, not
+        // to its continuation cell.
+        VirtualTerminal terminal(4, 2);
+        terminal.Feed("ab\xE4\xB8\xAD\xCC\x81");
+        CHECK_EQUAL(terminal.At(0, 2).Glyph, "\xE4\xB8\xAD\xCC\x81");
+        CHECK(terminal.At(0, 3).Glyph.empty());
+
+        terminal.Reset();
+        terminal.Feed("e\xCC\x81x");
+        CHECK_EQUAL(terminal.At(0, 0).Glyph, "e\xCC\x81");
+        CHECK_EQUAL(terminal.At(0, 1).Glyph, "x");
+    }
+
+    void TestMarkup() {
+        const std::string reset = Color::RESET;
+        const std::string bold = "\033[1m";
+        const std::string underline = "\033[4m";
+
+        Markup alert("[bold red]{}[/] failed after [yellow]{}[/] retries");
+        CHECK(alert.Arguments() == 2);
+        const std::string expected = std::string(Color::RED) + bold + "deploy" + reset + " failed after "
+            + Color::YELLOW + "3" + reset + " retries";
+        CHECK_EQUAL(alert.Render({ "deploy", "3" }), expected);
+        CHECK_EQUAL(alert.RenderView({ "deploy", "3" }), expected);
+        // Missing arguments render empty, without switching to their style.
+        CHECK_EQUAL(alert.Render({ "deploy" }), std::string(Color::RED) + bold + "deploy" + reset + " failed after  retries");
+
+        CHECK_EQUAL(Markup("[INFO] **a** \\[red] {{x}} [u]u[green]g[/]u[/]").Render(),
+            "[INFO] " + bold + "a" + reset + " [red] {x} " + underline + "u" + reset + Color::GREEN + underline + "g"
+            + reset + underline + "u" + reset);
+        CHECK_EQUAL(Markup("{:>5 red}|{1}{0}").Render({ "a", "b" }), std::string(Color::RED) + "    a" + reset + "|ba");
+
+        // The compile-time form produces the same runs and output.
+        static constexpr auto compiled = CONSOLETOOLS_MARKUP("[bold red]{}[/] failed after [yellow]{}[/] retries");
+        static_assert(compiled.Arguments() == 2, "StaticMarkup counts its arguments at compile time");
+        CHECK(compiled.Runs() == alert.Runs().size());
+        CHECK_EQUAL(compiled.Render({ "deploy", "3" }), expected);
+        CHECK_EQUAL(compiled.RenderView({ "deploy", "3" }), expected);
+
+        // RenderMarkup serves repeats from its cache and stays correct after the cache fills and starts over.
+        CHECK_EQUAL(RenderMarkup(alert.Template(), { "deploy", "3" }), expected);
+        for (int i = 0; i < 300; i++) {
+            std::string itemTemplate = "[green]item " + std::to_string(i) + "[/] {}";
+            CHECK_EQUAL(RenderMarkup(itemTemplate, { "ok" }), std::string(Color::GREEN) + "item " + std::to_string(i) + reset + " ok");
+        }
+        CHECK_EQUAL(RenderMarkupView(alert.Template(), { "deploy", "3" }), expected);
+        CHECK_EQUAL(RenderMarkup(alert.Template(), { "build", "1" }),
+            std::string(Color::RED) + bold + "build" + reset + " failed after " + Color::YELLOW + "1" + reset + " retries");
+    }
+
+    void TestFormat() {
+        const std::string reset = Color::RESET;
+        CHECK_EQUAL(Format("plain"), "plain");
+        CHECK_EQUAL(Format("{} + {} = {}", 1, 2u, 3LL), "1 + 2 = 3");
+        CHECK_EQUAL(Format("{1} {0}", "a", std::string("b")), "b a");
+        CHECK_EQUAL(Format("{:>5}|{:<5}|{:^5}|{:*^6}", 42, "ab", "x", 7), "   42|ab   |  x  |**7***");
+        CHECK_EQUAL(Format("{:05}|{:05}|{:x}|{:X}|{:o}|{:c}", -42, 42, 255, 255, 8, 65), "-0042|00042|ff|FF|10|A");
+        CHECK_EQUAL(Format("{} {:.2f} {:.3e} {:g} {:8.1f}", 0.1, 3.14159, 1234.5, 0.5, 2.25), "0.1 3.14 1.234e+03 0.5      2.2");
+        CHECK_EQUAL(Format("{} {} {}", true, 'c', std::string_view("sv")), "true c sv");
+        CHECK_EQUAL(Format("{:6}|", "漢字"), "漢字  |");   // padding counts columns, not bytes
+        CHECK_EQUAL(Format("{:red}", "x"), std::string(Color::RED) + "x" + reset);
+        CHECK_EQUAL(Format("[bold]{}[/] took {:>6.1f red} ms", "build", 12.34),
+            std::string("\033[1m") + "build" + reset + " took " + Color::RED + "  12.3" + reset + " ms");
+        CHECK_EQUAL(Format("{{{}}}", 5), "{5}");
+        CHECK_EQUAL(Format("{}", std::numeric_limits<long long>::min()), "-9223372036854775808");
+        CHECK_EQUAL(Format("{}", std::numeric_limits<unsigned long long>::max()), "18446744073709551615");
+
+        // More runs than a FormatString compiles ahead of time are parsed while formatting instead.
+        CHECK_EQUAL(Format("{}-{}-{}-{}-{}-{}-{}-{}-{}-{:>2}", 0, 1, 2, 3, 4, 5, 6, 7, 8, 9), "0-1-2-3-4-5-6-7-8- 9");
+        CHECK_EQUAL(Format("[red]{}[/]{}[red]{}[/]{}[red]{}[/]{}[red]{}[/]{}[red]{}[/]", 1, 2, 3, 4, 5, 6, 7, 8, 9),
+            std::string(Color::RED) + "1" + reset + "2" + Color::RED + "3" + reset + "4" + Color::RED + "5" + reset
+            + "6" + Color::RED + "7" + reset + "8" + Color::RED + "9" + reset);
+
+        std::string buffer;
+        FormatTo(buffer, "a{}", 1);
+        FormatTo(buffer, "b{}", 2);
+        CHECK_EQUAL(buffer, "a1b2");
+        CHECK_EQUAL(FormatView("{:>3}", 7), "  7");
+
+        CaptureSink capture;
+        SetOutputSink(&capture);
+        PrintFormat("x={}\n", 3);
+        FlushOutput();
+        SetOutputSink(nullptr);
+        CHECK_EQUAL(capture.Bytes(), "x=3\n");
+
+#if !defined(__cpp_consteval)
+        // Without consteval the checks run on the call and throw; with it these do not compile
+        // (see FormatCompileError.cpp).
+        auto throws = [](auto Call) {
+            try {
+                Call();
+            }
+            catch (const std::invalid_argument&) {
+                return true;
+            }
+            return false;
+        };
+        CHECK(throws([] { std::string spec = "{:q}"; Format(spec, 1); }));
+        CHECK(throws([] { Format("{} {}", 1); }));
+        CHECK(throws([] { Format("{:.2f}", "text"); }));
+        CHECK(throws([] { Format("a } b"); }));
+        CHECK(!throws([] { Format("{:.2f}", 1.0); }));
+#endif
+    }
+
+    void TestNestedViews() {
+        std::string header = Header("=", 30, "HEADER TEXT THAT IS LONG", " ", "", "", "");
+        CHECK_EQUAL(NotificationView("[", "!", "]", "INFO", HeaderView("=", 30, "HEADER TEXT THAT IS LONG", " ", "", "", ""), "", "", ""),
+            Notification("[", "!", "]", "INFO", header, "", "", ""));
+        std::string text(500, 'y');
+        CHECK_EQUAL(ErrorView(WarningView(ErrorView(text))), Error(Warning(Error(text))));
+    }
+
+    void TestSpinnerGroupFrames() {
+        VirtualClock clock;
+        SetClock(&clock);
+        CaptureSink capture;
+        SetOutputSink(&capture);
+
+        const auto interval = std::chrono::milliseconds(80);
+        {
+            SpinnerGroup group(1, interval);
+            int spinner = group.Add(0, 1, Spinners::LINE, "");
+            group.SetLabel(spinner, "working");
+
+            // The timer draws its first frame as soon as it starts, then one per tick of the clock.
+            const std::size_t first = capture.Frames().size();
+            group.Start();
+            CHECK(WaitFor([&] { return capture.Frames().size() > first; }));
+            VirtualTerminal terminal(20, 1);
+            for (int step = 1; step < 6; step++) {
+                std::size_t drawn = capture.Frames().size();
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                CHECK(capture.Frames().size() == drawn);
+                clock.Advance(interval);
+                CHECK(WaitFor([&] { return capture.Frames().size() > drawn; }));
+            }
+            group.Stop();
+
+            // One frame per tick, stamped with virtual time, each showing the next spinner glyph.
+            std::vector<CaptureSink::Chunk> frames = capture.Frames();
+            std::string bytes = capture.Bytes();
+            CHECK(frames.size() >= first + 6);
+            for (std::size_t i = first; i < first + 6 && i < frames.size(); i++) {
+                std::size_t step = i - first;
+                CHECK(frames[i].Time - frames[first].Time == interval * static_cast<int>(step));
+                terminal.Feed(std::string_view(bytes).substr(frames[i].Offset, frames[i].Size));
+                CHECK_EQUAL(terminal.At(0, 0).Glyph, Spinners::LINE.Frames[step % 4]);
+            }
+            CHECK_EQUAL(terminal.RowText(0), std::string(Spinners::LINE.Frames[5 % 4]) + " working");
+
+            // Stop() draws the final state and shows the cursor again.
+            VirtualTerminal replayed(20, 1);
+            replayed.Replay(capture);
+            CHECK(replayed.CursorVisible());
+        }
+
+        SetOutputSink(nullptr);
+        SetClock(nullptr);
+    }
+
+    void TestFrameMonitorAdaptsInterval() {
+        using std::chrono::milliseconds;
+        VirtualClock clock;
+        FrameMonitor monitor(milliseconds(16), milliseconds(100));
+        auto interval = [&monitor] { return std::chrono::duration_cast<milliseconds>(monitor.Interval()).count(); };
+
+        CHECK(monitor.ShouldDraw(clock.Now(), 0));
+        clock.Advance(milliseconds(4));
+        CHECK(!monitor.ShouldDraw(clock.Now(), 0));   // too early
+        clock.Advance(milliseconds(4));
+        CHECK(monitor.ShouldDraw(clock.Now(), 0));    // within half a MinInterval of due
+
+        // Slow writes double the interval, up to MaxInterval.
+        Clock::TimePoint start = clock.Now();
+        monitor.FrameWritten(start, start + milliseconds(10), 0);
+        CHECK(interval() == 32);
+        monitor.FrameWritten(start, start + milliseconds(10), 0);
+        CHECK(interval() == 64);
+        monitor.FrameWritten(start, start + milliseconds(10), 0);
+        CHECK(interval() == 64);                      // neither slow nor fast for 64 ms
+        monitor.FrameWritten(start, start, 512);
+        CHECK(interval() == 100);
+        CHECK(monitor.BackloggedFrames() == 1);
+
+        // A backlog drops frames however late they are.
+        clock.Advance(milliseconds(500));
+        CHECK(!monitor.ShouldDraw(clock.Now(), 512));
+        CHECK(monitor.ShouldDraw(clock.Now(), 0));
+
+        // Fast writes shrink it by an eighth per frame, down to MinInterval.
+        monitor.FrameWritten(start, start, 0);
+        CHECK(interval() == 87);
+        for (int i = 0; i < 20; i++) {
+            monitor.FrameWritten(start, start, 0);
+        }
+        CHECK(interval() == 16);
+
+        CHECK(monitor.FramesDrawn() == 3);
+        CHECK(monitor.FramesDropped() == 2);
+        CHECK(monitor.WriteLatency().Count() == 25);
+
+        monitor.Reset();
+        CHECK(interval() == 16);
+        CHECK(monitor.FramesDrawn() == 0 && monitor.FramesDropped() == 0 && monitor.WriteLatency().Count() == 0);
+    }
+
+#ifndef _WIN32
+    /**
+     * @brief Reads what the pipe holds right now from a non-blocking read end.
+     */
+    void ReadAvailable(int Descriptor, std::string& Out) {
+        char chunk[4096];
+        ssize_t length;
+        while ((length = read(Descriptor, chunk, sizeof(chunk))) > 0) {
+            Out.append(chunk, static_cast<std::size_t>(length));
+        }
+    }
+
+    void TestFileDescriptorSinkBacklog() {
+        int pipeEnds[2];
+        if (!CHECK(pipe(pipeEnds) == 0)) {
+            return;
+        }
+        fcntl(pipeEnds[0], F_SETFL, fcntl(pipeEnds[0], F_GETFL) | O_NONBLOCK);
+
+        std::string expected;
+        std::string received;
+        {
+            FileDescriptorSink sink(pipeEnds[1], 256);
+            CHECK(sink.SetNonBlocking(true));
+            CHECK((fcntl(pipeEnds[1], F_GETFL) & O_NONBLOCK) != 0);
+
+            // Nobody reads yet, so once the pipe is full the rest waits in the backlog.
+            for (int i = 0; i < 20000; i++) {
+                std::string line = "line " + std::to_string(i) + "\n";
+                sink.Write(line);
+                expected += line;
+            }
+            sink.Flush();
+            CHECK(sink.WouldBlockCount() > 0);
+            CHECK(sink.PendingBytes() > 0);
+            CHECK(sink.PendingBytes() < expected.size());
+
+            // Each flush hands over what the pipe has room for, in order.
+            for (int round = 0; round < 10000 && sink.PendingBytes() > 0; round++) {
+                ReadAvailable(pipeEnds[0], received);
+                sink.Flush();
+            }
+            CHECK(sink.PendingBytes() == 0);
+
+            sink.Write("tail\n");
+            expected += "tail\n";
+            CHECK(sink.SetNonBlocking(false));
+            CHECK((fcntl(pipeEnds[1], F_GETFL) & O_NONBLOCK) == 0);
+        }
+        close(pipeEnds[1]);
+        ReadAvailable(pipeEnds[0], received);
+        close(pipeEnds[0]);
+        CHECK(received.size() == expected.size());
+        CHECK(received == expected);
+    }
+
+    void TestGuardRestoresDescriptorFlags() {
+        // A sink making standard output non-blocking changes the open file the shell shares.
+        // If the program dies meanwhile, the guard's handler must make it blocking again.
+        int pipeEnds[2];
+        if (!CHECK(pipe(pipeEnds) == 0)) {
+            return;
+        }
+        std::fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            dup2(pipeEnds[1], STDOUT_FILENO);
+            TerminalStateGuard guard;
+            FileDescriptorSink sink(STDOUT_FILENO);
+            sink.SetNonBlocking(true);
+            raise(SIGTERM);
+            _exit(0);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+        CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+        CHECK((fcntl(pipeEnds[1], F_GETFL) & O_NONBLOCK) == 0);
+        close(pipeEnds[1]);
+
+        std::string written;
+        fcntl(pipeEnds[0], F_SETFL, O_NONBLOCK);
+        ReadAvailable(pipeEnds[0], written);
+        close(pipeEnds[0]);
+        CHECK_EQUAL(written, Color::RESET);
+
+        // Someone else left standard output non-blocking and the pipe is full: the handler waits
+        // for room instead of dropping the restore sequence.
+        if (!CHECK(pipe(pipeEnds) == 0)) {
+            return;
+        }
+        child = fork();
+        if (child == 0) {
+            dup2(pipeEnds[1], STDOUT_FILENO);
+            fcntl(STDOUT_FILENO, F_SETFL, fcntl(STDOUT_FILENO, F_GETFL) | O_NONBLOCK);
+            TerminalStateGuard guard;
+            const std::string filler(4096, 'x');
+            while (write(STDOUT_FILENO, filler.data(), filler.size()) > 0) {
+            }
+            raise(SIGTERM);
+            _exit(0);
+        }
+        close(pipeEnds[1]);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        written.clear();
+        char chunk[4096];
+        ssize_t length;
+        while ((length = read(pipeEnds[0], chunk, sizeof(chunk))) > 0) {
+            written.append(chunk, static_cast<std::size_t>(length));
+        }
+        close(pipeEnds[0]);
+        waitpid(child, &status, 0);
+        CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+        CHECK(written.size() >= 4 && written.compare(written.size() - 4, 4, Color::RESET) == 0);
+    }
+
+    /**
+     * @brief Runs Body in a child process whose standard output is a pipe.
+     * @return Everything the child wrote; Status receives its wait status.
+     */
+    template <typename Body>
+    std::string RunInChild(Body&& Run, int& Status) {
+        int pipeEnds[2];
+        if (pipe(pipeEnds) != 0) {
+            Status = -1;
+            return std::string();
+        }
+        std::fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            dup2(pipeEnds[1], STDOUT_FILENO);
+            close(pipeEnds[0]);
+            Run();
+            _exit(0);
+        }
+        close(pipeEnds[1]);
+        std::string written;
+        char chunk[4096];
+        ssize_t length;
+        while ((length = read(pipeEnds[0], chunk, sizeof(chunk))) > 0) {
+            written.append(chunk, static_cast<std::size_t>(length));
+        }
+        close(pipeEnds[0]);
+        waitpid(child, &Status, 0);
+        return written;
+    }
+
+    void TestGuardRestoreSequence() {
+        const std::string entered = "\033[?25l\033[?1049h";
+        int status = 0;
+
+        // A terminating signal writes the reset for every mode still changed, in one go.
+        std::string written = RunInChild([] {
+            TerminalStateGuard guard;
+            HideCursor();
+            EnterAlternateScreen();
+            FlushOutput();
+            raise(SIGTERM);
+        }, status);
+        CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+        CHECK_EQUAL(Printable(written), Printable(entered + Color::RESET + "\033[?25h\033[?1049l"));
+
+        // Modes undone before the signal are not undone twice.
+        written = RunInChild([] {
+            TerminalStateGuard guard;
+            HideCursor();
+            EnterAlternateScreen();
+            ShowCursor();
+            LeaveAlternateScreen();
+            FlushOutput();
+            raise(SIGTERM);
+        }, status);
+        CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+        CHECK_EQUAL(Printable(written), Printable(entered + "\033[?25h\033[?1049l" + Color::RESET));
+
+        // Leaving the guard's scope restores as well, and its handlers go with it.
+        written = RunInChild([] {
+            {
+                TerminalStateGuard guard;
+                HideCursor();
+                EnterAlternateScreen();
+            }
+            raise(SIGTERM);
+        }, status);
+        CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+        CHECK_EQUAL(Printable(written), Printable(entered + Color::RESET + "\033[?25h\033[?1049l"));
+    }
+#endif
+
+    void TestMessageSuppressor() {
+        VirtualClock clock;
+        SetClock(&clock);
+
+        MessageSuppressor suppressor(5.0, 10);
+        std::uint64_t repeated = 0;
+        int allowed = 0;
+        for (int i = 0; i < 100; i++) {
+            allowed += suppressor.Allow("disk full", repeated);
+        }
+        CHECK(allowed == 10);
+        clock.Advance(std::chrono::milliseconds(200));
+        CHECK(suppressor.Allow("disk full", repeated));
+        CHECK(repeated == 90);
+
+        // Unique messages share the overflow bucket once the table is full instead of going unlimited.
+        int passed = 0;
+        for (int i = 0; i < 5000; i++) {
+            passed += suppressor.Allow("request " + std::to_string(i) + " failed", repeated);
+        }
+        CHECK(passed < 5000);
+
+        // Idle slots are reclaimed.
+        clock.Advance(std::chrono::seconds(10));
+        suppressor.TakeSummaries();
+        allowed = 0;
+        for (int i = 0; i < 50; i++) {
+            allowed += suppressor.Allow("fresh message", repeated);
+        }
+        CHECK(allowed == 10);
+        std::vector<std::string> summaries = suppressor.TakeSummaries();
+        CHECK(summaries.size() == 1);
+        if (!summaries.empty()) {
+            CHECK_EQUAL(summaries[0], "fresh message (repeated 40 times)");
+        }
+
+        // Decisions for a live key stay exact while other threads claim and reclaim slots around it.
+        MessageSuppressor shared(5.0, 10);
+        std::atomic<int> hotAllowed{ 0 };
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&, t] {
+                std::uint64_t count = 0;
+                for (int i = 0; i < 2000; i++) {
+                    hotAllowed += shared.Allow("hot message", count);
+                    shared.Allow("unique " + std::to_string(t * 100000 + i), count);
+                    if (i % 500 == 0) {
+                        shared.TakeSummaries();
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        CHECK(hotAllowed == 10);
+
+        SetClock(nullptr);
+    }
+
+    void TestLoggerReentrancy() {
+        std::ostringstream out;
+        Logger logger(out);
+        logger.SetShowTimestamps(false);
+        logger.Log(LogLevel::Info, "outer start ", [&] {
+            logger.Log(LogLevel::Info, "inner ", 42);
+            return std::string("lazy");
+        }, " outer end");
+        std::string text = out.str();
+        CHECK(text.find("inner 42") != std::string::npos);
+        CHECK(text.find("outer start lazy outer end") != std::string::npos);
+    }
+
+    struct Test {
+        const char* Name;
+        void (*Run)();
+    };
+
+    const Test tests[] = {
+        { "WidgetsMatchBuilders", TestWidgetsMatchBuilders },
+        { "BatchMatchesSingleBars", TestBatchMatchesSingleBars },
+        { "WrapTextStaysWithinWidth", TestWrapTextStaysWithinWidth },
+        { "SeriesBufferMinMaxAfterEviction", TestSeriesBufferMinMaxAfterEviction },
+        { "HistogramBucketBounds", TestHistogramBucketBounds },
+        { "ConcurrentHistogramIntervals", TestConcurrentHistogramIntervals },
+        { "InstrumentationSnapshot", TestInstrumentationSnapshot },
+        { "LayoutArrange", TestLayoutArrange },
+        { "FrameBufferDiff", TestFrameBufferDiff },
+        { "VirtualTerminalCombiningMarks", TestVirtualTerminalCombiningMarks },
+        { "Markup", TestMarkup },
+        { "Format", TestFormat },
+        { "NestedViews", TestNestedViews },
+        { "SpinnerGroupFrames", TestSpinnerGroupFrames },
+        { "FrameMonitorAdaptsInterval", TestFrameMonitorAdaptsInterval },
+#ifndef _WIN32
+        { "FileDescriptorSinkBacklog", TestFileDescriptorSinkBacklog },
+        { "GuardRestoresDescriptorFlags", TestGuardRestoresDescriptorFlags },
+        { "GuardRestoreSequence", TestGuardRestoreSequence },
+#endif
+        { "MessageSuppressor", TestMessageSuppressor },
+        { "LoggerReentrancy", TestLoggerReentrancy },
+    };
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int run = 0;
+    for (const Test& test : tests) {
+        if (argc > 1 && std::strcmp(argv[1], test.Name) != 0) {
+            continue;
+        }
+        int before = failures;
+        test.Run();
+        std::printf("%-34s %s\n", test.Name, failures == before ? "ok" : "FAILED");
+        run++;
+    }
+
+    if (run == 0) {
+        std::printf("No test named %s\n", argv[1]);
+        return 1;
+    }
+    std::printf("%d test(s), %d failed check(s)\n", run, failures);
+    return failures == 0 ? 0 : 1;
+}